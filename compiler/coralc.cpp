@@ -3,64 +3,528 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdarg>
+#include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <new>
+#include <string_view>
+#include <charconv>
 #include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 
 namespace Util {
 
+    //QUIET: keine Ausgabe, SUMMARY: ParseInfo am Ende, TRACE: zusätzlich Debug Ausgaben von Tokenizer und Parser
+    enum Verbosity {
+        QUIET,
+        SUMMARY,
+        TRACE
+    };
+
+    int verbosity = QUIET;
+
+    inline bool log_enabled(int level) {
+        return verbosity >= level;
+    }
+
+    //gepufferte Ausgabe nach stderr. Jeder Thread sammelt in einem eigenen Puffer, der nur als Ganzes geschrieben wird,
+    //dadurch vermischen sich die Ausgaben paralleler Threads nicht innerhalb einer Zeile
+    class LogBuffer final {
+    public:
+        static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+        ~LogBuffer() {
+            flush();
+        }
+
+        void append(const char* format, va_list arguments) {
+            va_list copy;
+            va_copy(copy, arguments);
+            int length = vsnprintf(nullptr, 0, format, copy);
+            va_end(copy);
+            if (length <= 0)
+                return;
+            size_t used = text.size();
+            text.resize(used + length + 1);
+            vsnprintf(&text[used], length + 1, format, arguments);
+            text.resize(used + length);
+            if (text.size() >= FLUSH_THRESHOLD)
+                flush();
+        }
+
+        void flush() {
+            if (text.empty())
+                return;
+            static std::mutex output_mutex;
+            std::lock_guard<std::mutex> lock(output_mutex);
+            fwrite(text.data(), 1, text.size(), stderr);
+            fflush(stderr);
+            text.clear();
+        }
+
+    private:
+        std::string text;
+    };
+
+    inline LogBuffer& log_buffer() {
+        static thread_local LogBuffer buffer;
+        return buffer;
+    }
+
+    __attribute__((format(printf, 2, 3)))
+    void log(int level, const char* format, ...) {
+        if (!log_enabled(level))
+            return;
+        va_list arguments;
+        va_start(arguments, format);
+        log_buffer().append(format, arguments);
+        va_end(arguments);
+    }
+
+    void log_flush() {
+        log_buffer().flush();
+    }
+
     void error(const char* message) {
-        printf(message);
+        printf("%s", message);
         printf("\n");
         exit(-1);
     }
 
-    std::string read_file(const char* path) {
-        std::ifstream in_stream(path);
-        std::string content((std::istreambuf_iterator<char>(in_stream)),(std::istreambuf_iterator<char>()));
-        return content;
+    //Zeitmessung und Zähler für --time-passes und --stats. Alles ist atomar, da die Phasen pro Datei auf mehreren Threads laufen
+    enum Phase {
+        PHASE_READ,
+        PHASE_CACHE,
+        //Tokenizer und Parser laufen verschränkt, die Zeit des Tokenizers steckt mit drin
+        PHASE_PARSE,
+        PHASE_MERGE,
+        PHASE_LAYOUT,
+        PHASE_BODIES,
+        PHASE_DEVIRTUALIZE,
+        PHASE_FOLD,
+        PHASE_ESCAPE,
+        PHASE_DEAD_CODE,
+        PHASE_BYTECODE,
+        PHASE_EMIT,
+        PHASE_RUN,
+        PHASE_COUNT
+    };
+
+    constexpr const char* PHASE_NAMES[] = {"read", "cache", "tokenize+parse", "merge", "layout", "bodies", "devirtualize", "fold", "escape", "dead_code", "bytecode", "emit", "run"};
+    static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == PHASE_COUNT, "PHASE_NAMES must cover every phase");
+
+    enum Counter {
+        COUNTER_FILES,
+        COUNTER_BYTES,
+        COUNTER_TOKENS,
+        COUNTER_IDENTIFIERS,
+        COUNTER_TYPES,
+        COUNTER_FUNCTIONS,
+        COUNTER_GLOBALS,
+        COUNTER_CACHE_HITS,
+        COUNTER_CACHE_MISSES,
+        COUNTER_ARENA_BYTES,
+        COUNTER_ARENA_BLOCKS,
+        COUNTER_INSTRUCTIONS,
+        COUNTER_VIRTUAL_CALLS,
+        COUNTER_DEVIRTUALIZED_CALLS,
+        COUNTER_INLINED_CALLS,
+        COUNTER_FOLDED_EXPRESSIONS,
+        COUNTER_IMAGE_GLOBALS,
+        COUNTER_DEAD_FUNCTIONS,
+        COUNTER_DEAD_TYPES,
+        COUNTER_DEAD_GLOBALS,
+        COUNTER_REPLACED_OBJECTS,
+        COUNTER_COUNT
+    };
+
+    constexpr const char* COUNTER_NAMES[] = {"files", "bytes", "tokens", "identifiers", "types", "functions", "globals",
+                                             "cache_hits", "cache_misses", "arena_bytes", "arena_blocks", "instructions",
+                                             "virtual_calls", "devirtualized_calls", "inlined_calls", "folded_expressions", "image_globals",
+                                             "dead_functions", "dead_types", "dead_globals", "replaced_objects"};
+    static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == COUNTER_COUNT, "COUNTER_NAMES must cover every counter");
+
+    class Stats final {
+    public:
+        //solange das aus ist, kosten Timer und Zähler nur einen Vergleich
+        bool enabled = false;
+
+        void add(Counter counter, uint64_t value) {
+            if (enabled)
+                counters[counter].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void add_time(Phase phase, uint64_t nanoseconds) {
+            phase_nanoseconds[phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+            phase_calls[phase].fetch_add(1, std::memory_order_relaxed);
+            //ru_maxrss ist der Höchststand des ganzen Prozesses bis jetzt, nicht der Verbrauch der Phase. Gemerkt wird der Stand
+            //am Ende der Phase
+            uint64_t rss = peak_rss_kb();
+            uint64_t previous = phase_peak_rss_kb[phase].load(std::memory_order_relaxed);
+            while (previous < rss && !phase_peak_rss_kb[phase].compare_exchange_weak(previous, rss, std::memory_order_relaxed)) {
+            }
+        }
+
+        static uint64_t peak_rss_kb() {
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) != 0)
+                return 0;
+            return static_cast<uint64_t>(usage.ru_maxrss);
+        }
+
+        void report(bool times, bool counts, bool json, uint64_t wall_nanoseconds) {
+            if (json) {
+                fprintf(stderr, "{\"wall_ms\": %.3f, \"peak_rss_kb\": %llu", wall_nanoseconds / 1e6, static_cast<unsigned long long>(peak_rss_kb()));
+                if (times) {
+                    fprintf(stderr, ", \"phases\": {");
+                    for (int i = 0; i < PHASE_COUNT; ++i) {
+                        fprintf(stderr, "%s\"%s\": {\"ms\": %.3f, \"calls\": %llu, \"process_max_rss_kb\": %llu}", i == 0 ? "" : ", ", PHASE_NAMES[i],
+                                phase_nanoseconds[i].load() / 1e6, static_cast<unsigned long long>(phase_calls[i].load()),
+                                static_cast<unsigned long long>(phase_peak_rss_kb[i].load()));
+                    }
+                    fprintf(stderr, "}");
+                }
+                if (counts) {
+                    fprintf(stderr, ", \"counters\": {");
+                    for (int i = 0; i < COUNTER_COUNT; ++i)
+                        fprintf(stderr, "%s\"%s\": %llu", i == 0 ? "" : ", ", COUNTER_NAMES[i], static_cast<unsigned long long>(counters[i].load()));
+                    fprintf(stderr, "}");
+                }
+                fprintf(stderr, "}\n");
+                return;
+            }
+            if (times) {
+                //die Phasen pro Datei laufen parallel, ihre Zeiten sind über alle Threads aufsummiert
+                fprintf(stderr, "%-14s %12s %8s %22s\n", "phase", "time (ms)", "calls", "process max rss (kB)");
+                for (int i = 0; i < PHASE_COUNT; ++i) {
+                    if (phase_calls[i].load() == 0)
+                        continue;
+                    fprintf(stderr, "%-14s %12.3f %8llu %22llu\n", PHASE_NAMES[i], phase_nanoseconds[i].load() / 1e6,
+                            static_cast<unsigned long long>(phase_calls[i].load()), static_cast<unsigned long long>(phase_peak_rss_kb[i].load()));
+                }
+                fprintf(stderr, "%-14s %12.3f %8s %22llu\n", "total", wall_nanoseconds / 1e6, "", static_cast<unsigned long long>(peak_rss_kb()));
+            }
+            if (counts) {
+                for (int i = 0; i < COUNTER_COUNT; ++i)
+                    fprintf(stderr, "%-19s %llu\n", COUNTER_NAMES[i], static_cast<unsigned long long>(counters[i].load()));
+            }
+        }
+
+    private:
+        std::atomic<uint64_t> phase_nanoseconds[PHASE_COUNT] = {};
+        std::atomic<uint64_t> phase_calls[PHASE_COUNT] = {};
+        std::atomic<uint64_t> phase_peak_rss_kb[PHASE_COUNT] = {};
+        std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+    };
+
+    Stats stats;
+
+    //misst die Zeit bis zum Ende des Scopes und rechnet sie der Phase zu
+    class PhaseTimer final {
+    public:
+        explicit PhaseTimer(Phase phase) : phase(phase), active(stats.enabled) {
+            if (active)
+                start = std::chrono::steady_clock::now();
+        }
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        ~PhaseTimer() {
+            if (active) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                stats.add_time(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        }
+
+    private:
+        Phase phase;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    //Inhalt einer Quelldatei. Die Datei wird nach Möglichkeit per mmap eingeblendet, damit der Tokenizer direkt
+    //auf den Seiten des Page Caches arbeiten kann. Falls das nicht geht (Pipes, /dev/stdin etc.) wird per read() eingelesen
+    class SourceBuffer final {
+    public:
+        SourceBuffer() = default;
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+        SourceBuffer(SourceBuffer&& other) noexcept {
+            take(other);
+        }
+
+        SourceBuffer& operator=(SourceBuffer&& other) noexcept {
+            if (this != &other) {
+                release();
+                take(other);
+            }
+            return *this;
+        }
+
+        ~SourceBuffer() {
+            release();
+        }
+
+        bool open(const char* path) {
+            release();
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+                void* address = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    //der Tokenizer liest die Datei genau einmal von vorne nach hinten
+                    madvise(address, file_stat.st_size, MADV_SEQUENTIAL);
+                    content = static_cast<const char*>(address);
+                    length = file_stat.st_size;
+                    mapped = true;
+                    ::close(fd);
+                    return true;
+                }
+            }
+            bool success = read_all(fd);
+            ::close(fd);
+            return success;
+        }
+
+        const char* data() const {
+            return content;
+        }
+
+        size_t size() const {
+            return length;
+        }
+
+        std::string_view view() const {
+            return std::string_view(content == nullptr ? "" : content, length);
+        }
+
+        bool is_mapped() const {
+            return mapped;
+        }
+
+    private:
+        const char* content = nullptr;
+        size_t length = 0;
+        bool mapped = false;
+
+        bool read_all(int fd) {
+            size_t capacity = 64 * 1024;
+            char* buffer = static_cast<char*>(malloc(capacity));
+            size_t used = 0;
+            while (buffer != nullptr) {
+                if (used == capacity) {
+                    capacity *= 2;
+                    char* grown = static_cast<char*>(realloc(buffer, capacity));
+                    if (grown == nullptr) {
+                        free(buffer);
+                        buffer = nullptr;
+                        break;
+                    }
+                    buffer = grown;
+                }
+                ssize_t count = ::read(fd, buffer + used, capacity - used);
+                if (count < 0) {
+                    free(buffer);
+                    return false;
+                }
+                if (count == 0)
+                    break;
+                used += count;
+            }
+            if (buffer == nullptr)
+                return false;
+            content = buffer;
+            length = used;
+            return true;
+        }
+
+        void take(SourceBuffer& other) {
+            content = other.content;
+            length = other.length;
+            mapped = other.mapped;
+            other.content = nullptr;
+            other.length = 0;
+            other.mapped = false;
+        }
+
+        void release() {
+            if (content != nullptr) {
+                if (mapped)
+                    munmap(const_cast<char*>(content), length);
+                else
+                    free(const_cast<char*>(content));
+            }
+            content = nullptr;
+            length = 0;
+            mapped = false;
+        }
+    };
+
+    SourceBuffer read_file(const char* path) {
+        SourceBuffer buffer;
+        if (!buffer.open(path)) {
+            printf("Could not read file: %s\n", path);
+            exit(-1);
+        }
+        //Tokens speichern 32 Bit Offsets in den Quelltext
+        if (buffer.size() > UINT32_MAX)
+            error("Source files larger than 4 GiB are not supported");
+        return buffer;
+    }
+
+    bool write_file(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), content.size());
+        return static_cast<bool>(file);
     }
 
+    //liest eine Datei in Blöcken fester Größe. Der Speicherbedarf hängt nur von der Blockgröße und dem längsten Token ab,
+    //nicht von der Größe der Datei
+    class ChunkedReader final {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+        explicit ChunkedReader(size_t chunk_size = DEFAULT_CHUNK_SIZE) {
+            this->chunk_size = chunk_size;
+        }
+
+        ChunkedReader(const ChunkedReader&) = delete;
+        ChunkedReader& operator=(const ChunkedReader&) = delete;
+
+        ~ChunkedReader() {
+            if (fd >= 0)
+                ::close(fd);
+            free(buffer);
+        }
+
+        bool open(const char* path) {
+            fd = ::open(path, O_RDONLY);
+            if (fd < 0)
+                return false;
+#ifdef POSIX_FADV_SEQUENTIAL
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            return true;
+        }
+
+        //liest statt aus einer Datei über source, z.B. aus einem Dokument des Servers. Die Offsets beginnen bei start_offset
+        void open(std::function<size_t(char* target, size_t count)> source, uint64_t start_offset) {
+            this->source = std::move(source);
+            window_offset = start_offset;
+        }
+
+        //behält die Bytes ab keep bis zum Ende des aktuellen Fensters, schiebt sie an den Anfang des Puffers und liest den
+        //nächsten Block dahinter. Danach ist das Fenster [data(), data() + size()). Liefert false, wenn nichts mehr kam
+        bool refill(const char* keep) {
+            size_t kept = 0;
+            if (keep != nullptr) {
+                kept = buffer + used - keep;
+                window_offset += keep - buffer;
+                memmove(buffer, keep, kept);
+            } else {
+                window_offset += used;
+            }
+            used = kept;
+            if (capacity - used < chunk_size) {
+                //ein einzelnes Token ist länger als ein Block
+                capacity = used + chunk_size;
+                char* grown = static_cast<char*>(realloc(buffer, capacity));
+                if (grown == nullptr)
+                    error("Out of memory");
+                buffer = grown;
+            }
+            size_t read_count = 0;
+            while (read_count < chunk_size && (fd >= 0 || source)) {
+                ssize_t count = fd >= 0 ? ::read(fd, buffer + used + read_count, chunk_size - read_count)
+                                        : static_cast<ssize_t>(source(buffer + used + read_count, chunk_size - read_count));
+                if (count <= 0)
+                    break;
+                read_count += count;
+            }
+            used += read_count;
+            total_read += read_count;
+            return read_count > 0;
+        }
+
+        const char* data() const {
+            return buffer;
+        }
+
+        size_t size() const {
+            return used;
+        }
+
+        //Position von data() in der Datei
+        uint64_t offset() const {
+            return window_offset;
+        }
+
+        uint64_t bytes_read() const {
+            return total_read;
+        }
+
+    private:
+        int fd = -1;
+        std::function<size_t(char* target, size_t count)> source;
+        size_t chunk_size;
+        char* buffer = nullptr;
+        size_t capacity = 0;
+        size_t used = 0;
+        uint64_t window_offset = 0;
+        uint64_t total_read = 0;
+    };
+
     inline bool str_equals(const char* str1, const char* str2) {
         return strcmp(str1, str2) == 0;
     }
 
+    inline bool str_equals(std::string_view str1, const char* str2) {
+        return str1 == str2;
+    }
+
     inline bool str_starts_with(const char* str, const char* prefix) {
         const char* pointer = strstr(str, prefix);
         return pointer == str;
     }
 
-    inline std::string substr_till_one_before_end(const char* str, size_t index) {
-        std::string cpp_str = str;
-        size_t length = cpp_str.length();
-        std::string substring = cpp_str.substr(index-1, length-index);
-        return substring;
+    inline bool str_starts_with(std::string_view str, const char* prefix) {
+        return str.compare(0, strlen(prefix), prefix) == 0;
     }
 
-    constexpr const char* NUMS = "0123456789";
-    constexpr int NUMS_COUNT = 10;
-
     inline bool is_number(char c) {
-        for (int i = 0; i < NUMS_COUNT; ++i) {
-            if (c == NUMS[i])
-                return true;
-        }
-        return false;
-    }
-
-    inline bool is_str_number(const char* str) {
-        int i = 0;
-        bool has_period = false;
-        while(str[i] != '\0') {
-            if (str[i] == '.') {
-                if (has_period)
-                    return false;
-                else
-                    has_period = true;
-            } else if (!is_number(str[i])) {
-                return false;
-            }
-            ++i;
-        }
-        return true;
+        return c >= '0' && c <= '9';
     }
 
     inline bool is_str_literal(const char* str) {
@@ -81,7 +545,7 @@ namespace Util {
     }
 
     inline bool is_whitespace(char c) {
-        return c == ' ';
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
     }
 
     inline bool is_newline(char c) {
@@ -96,587 +560,9113 @@ namespace Util {
         return flag ? "true" : "false";
     }
 
-}
+    inline uint64_t mix_hash(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
 
-namespace Tokenization {
+    //schneller, nicht kryptografischer Hash, der 8 Bytes pro Schritt verarbeitet
+    inline uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        const uint64_t k1 = 0x9E3779B97F4A7C15ULL;
+        const uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+        uint64_t hash = seed ^ (size * k1);
+        while (size >= 8) {
+            uint64_t word;
+            memcpy(&word, bytes, 8);
+            hash ^= word * k2;
+            hash = ((hash << 31) | (hash >> 33)) * k1;
+            bytes += 8;
+            size -= 8;
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, bytes, size);
+        hash ^= tail * k2;
+        return mix_hash(hash);
+    }
 
-    enum TokenType {
-        //zunächst werden alle Namen (die keine Zahl-, String-, oder Boolean Literals sind) zu Placeholdern.
-        //im nächsten Schritt werden diese dann durch entsprechende Keyword Tokens ersätzt
-        PLACEHOLDER = 0,
-        NUM_LITERAL = 1,
-        STR_LITERAL = 2,
-        BOOL_LITERAL = 3,
-        //Nutzerdefinierter identifier (Funktions-/Variablenname etc.)
-        NAME = 4,
-        //Funktionsdeklarationskeyword. Value ist gleich dem Rückgabewert
-        DECL_FUNCTION = 5,
-        //Keywords der Sprache
-        INTRINSIC = 6,
-        LINKED = 7,
-        NUM = 8,
-        STR = 9,
-        BOOL = 10,
-        //Zeichen
-        SEMICOLON = 11,
-        OPEN_CURLY = 12,
-        CLOSE_CURLY = 13,
-        OPEN_PARA = 14,
-        CLOSE_PARA = 15,
-        COMMA = 16,
-        PERIOD = 17,
-        EQUALS = 18,
-        //weitere keywords
-        TYPE = 19,
-        FROM = 20
-    };
+    //Thread Pool, bei dem jeder Worker eine eigene Warteschlange hat. Ein Worker arbeitet seine Schlange von hinten ab
+    //und stiehlt, sobald sie leer ist, von vorne aus den Schlangen der anderen. Der aufrufende Thread arbeitet als Worker 0 mit
+    class WorkStealingPool final {
+    public:
+        //0 bedeutet: so viele Threads wie die Maschine Kerne hat
+        explicit WorkStealingPool(size_t thread_count = 0) {
+            if (thread_count == 0)
+                thread_count = std::thread::hardware_concurrency();
+            if (thread_count == 0)
+                thread_count = 1;
+            this->thread_count = thread_count;
+            queues.reset(new WorkQueue[thread_count]);
+            for (size_t i = 1; i < thread_count; ++i)
+                threads.emplace_back(&WorkStealingPool::worker_loop, this, i);
+        }
 
-    const char* type_to_string(TokenType type) {
-        switch (type) {
-            case PLACEHOLDER: return "Placeholder";
-            case NUM_LITERAL: return "Number Literal";
-            case STR_LITERAL: return "String Literal";
-            case BOOL_LITERAL: return "Boolean Literal";
-            case NAME: return "Name";
-            case DECL_FUNCTION: return "Function Declaration";
-            case INTRINSIC: return "Intrinsic";
-            case LINKED: return "Linked";
-            case NUM: return "Number Declaration";
-            case STR: return "String Declaration";
-            case BOOL: return "Boolean Declaration";
-            case SEMICOLON: return ";";
-            case OPEN_CURLY: return "{";
-            case CLOSE_CURLY: return "}";
-            case OPEN_PARA: return "(";
-            case CLOSE_PARA: return ")";
-            case COMMA: return ",";
-            case PERIOD: return ".";
-            case EQUALS: return "Equals";
-            case TYPE: return "Type";
-            case FROM: return "From";
-        }
-        return "";
-    }
-
-    union TokenValue {
-        bool bool_value;
-        int int_value;
-        float float_value;
-        std::string* str_value;
-    };
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
 
-    struct Token {
-        TokenType type;
-        TokenValue *value = nullptr;
-    };
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                stopping = true;
+            }
+            wake_condition.notify_all();
+            for (std::thread& thread : threads)
+                thread.join();
+        }
 
-    const char* get_str_value(Token token) {
-        return token.value->str_value->c_str();
-    }
+        size_t size() const {
+            return thread_count;
+        }
 
-    //die Symbole sollten hier in der gleichen Reihenfolge wie in TokenType aufgeführt werden, die get_symbol_type Funktion arbeitet mit dieser Annahme
-    constexpr const char* SYMBOLS = ";{}(),.=";
-    constexpr const int SYMBOL_COUNT = 8;
+        //Index des ausführenden Workers, z.B. für Speicher pro Thread
+        static size_t current_worker() {
+            return worker_index;
+        }
 
-    bool is_symbol(char c) {
-        for (int i = 0; i < SYMBOL_COUNT; ++i) {
-            if (SYMBOLS[i] == c)
-                return true;
+        //führt task(i) für alle i in [0, count) aus und kehrt erst zurück, wenn alle fertig sind. Darf nicht verschachtelt werden
+        void parallel_for(size_t count, const std::function<void(size_t)>& task) {
+            if (count == 0)
+                return;
+            if (thread_count == 1 || count == 1) {
+                for (size_t i = 0; i < count; ++i)
+                    task(i);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                current_task = &task;
+                remaining.store(count);
+                for (size_t i = 0; i < count; ++i) {
+                    WorkQueue& queue = queues[i % thread_count];
+                    std::lock_guard<std::mutex> queue_lock(queue.mutex);
+                    queue.items.push_back(i);
+                }
+                ++generation;
+            }
+            wake_condition.notify_all();
+            while (run_one(0)) {
+            }
+            std::unique_lock<std::mutex> lock(state_mutex);
+            done_condition.wait(lock, [this] { return remaining.load() == 0; });
+            current_task = nullptr;
         }
-        return false;
-    }
 
-    TokenType get_symbol_type(char c) {
-        int symbol_index = -1;
-        for (int i = 0; i < SYMBOL_COUNT; ++i) {
-            if (SYMBOLS[i] == c) {
-                symbol_index = i;
-                break;
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        size_t thread_count;
+        std::unique_ptr<WorkQueue[]> queues;
+        std::vector<std::thread> threads;
+        std::mutex state_mutex;
+        std::condition_variable wake_condition;
+        std::condition_variable done_condition;
+        const std::function<void(size_t)>* current_task = nullptr;
+        std::atomic<size_t> remaining{0};
+        uint64_t generation = 0;
+        bool stopping = false;
+        static thread_local size_t worker_index;
+
+        bool pop_local(size_t worker, size_t& item) {
+            WorkQueue& queue = queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.items.empty())
+                return false;
+            item = queue.items.back();
+            queue.items.pop_back();
+            return true;
+        }
+
+        bool steal(size_t worker, size_t& item) {
+            for (size_t offset = 1; offset < thread_count; ++offset) {
+                WorkQueue& queue = queues[(worker + offset) % thread_count];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.items.empty()) {
+                    item = queue.items.front();
+                    queue.items.pop_front();
+                    return true;
+                }
             }
+            return false;
         }
-        if (symbol_index == -1)
-            return TokenType::PLACEHOLDER;
-        //11 ist der Index des ersten Symbols in TokenType
-        return static_cast<TokenType>(11 + symbol_index);
-    }
 
-    
-    void print_token(Tokenization::Token token) {
-        printf("==========\n");
-        printf("Type: ");
-        printf(type_to_string(token.type));
-        printf("\n");
-        if (token.value != nullptr) {
-            const char* value = nullptr;
-            switch (token.type) {
-                case Tokenization::TokenType::STR_LITERAL:
-                case Tokenization::TokenType::NAME:
-                case Tokenization::TokenType::DECL_FUNCTION:
-                case Tokenization::TokenType::PLACEHOLDER:
-                    value = token.value->str_value->c_str();
-                    break;
-                case Tokenization::TokenType::NUM_LITERAL:
-                    value = std::to_string(token.value->float_value).c_str();
-                    break;
-                case Tokenization::TokenType::BOOL_LITERAL:
-                    value = Util::bool_to_str(token.value->bool_value);
-                    break;
+        bool run_one(size_t worker) {
+            size_t item;
+            if (!pop_local(worker, item) && !steal(worker, item))
+                return false;
+            (*current_task)(item);
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                done_condition.notify_all();
             }
-            if (value != nullptr) {
-                printf("value: ");
-                printf(value);
-                printf("\n");
+            return true;
+        }
+
+        void worker_loop(size_t worker) {
+            worker_index = worker;
+            uint64_t seen_generation = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(state_mutex);
+                    wake_condition.wait(lock, [&] { return stopping || generation != seen_generation; });
+                    if (stopping)
+                        return;
+                    seen_generation = generation;
+                }
+                while (run_one(worker)) {
+                }
             }
         }
-    }
+    };
 
-    class Tokenizer final {
+    thread_local size_t WorkStealingPool::worker_index = 0;
+
+    //Bump Allocator für alles, was genauso lange lebt wie eine Kompilierung. Es wird nie einzeln freigegeben,
+    //sondern nur der komplette Speicher am Ende
+    class Arena final {
     public:
-        Tokenizer(std::string content) {
-            this->content = content;
-            this->length = content.size();
-            printf("created tokenizer\n");
-            printf("content is: \n");
-            printf(content.c_str());
-            printf("\n");
+        explicit Arena(size_t block_size = 64 * 1024) {
+            this->block_size = block_size;
         }
 
-        std::vector<Token> tokenize() {
-            while (!is_eof()) {
-                char c = current();
-                if (Util::is_ignored_character(c)) {
-                    consume();
-                } else if (current() == '"') {
-                    parse_string_literal();
-                } else {
-                    parse_name_or_symbol();
-                }
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() {
+            while (head != nullptr) {
+                Block* previous = head->previous;
+                free(head);
+                head = previous;
             }
-            return tokens;
         }
 
-        void print_all_tokens() {
-            printf("token count %d\n", tokens.size());
-            for (int i = 0; i < tokens.size(); ++i) {
-                print_token(tokens[i]);
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            if (head == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+                add_block(size + alignment);
+                aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
             }
-            printf("\n");
+            cursor = reinterpret_cast<char*>(aligned + size);
+            used += size;
+            return reinterpret_cast<void*>(aligned);
         }
 
-
-    private:
-        std::string content;
-        size_t pointer = 0, length;
-        std::vector<Token> tokens;
-
-        void move_pointer(int steps) {
-            pointer += steps;
+        template<typename T, typename... Args>
+        T* create(Args&&... args) {
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
         }
 
-        char consume() {
-            char c = content[pointer];
-            ++pointer;
-            return c;
+        std::string_view copy(std::string_view text) {
+            char* target = static_cast<char*>(allocate(text.size() + 1, 1));
+            memcpy(target, text.data(), text.size());
+            target[text.size()] = '\0';
+            return std::string_view(target, text.size());
         }
 
-        char current() {
-            return content[pointer];
+        size_t bytes_used() const {
+            return used;
         }
 
-        bool is_eof() {
-            return pointer >= length;
+        size_t block_count() const {
+            return blocks;
         }
 
-        char previous(int skips = 0) {
-            size_t new_pointer = this->pointer - skips - 1;
-            if (new_pointer < 0)
-                new_pointer = 0;
-            return content[new_pointer];
+    private:
+        struct Block {
+            Block* previous;
+        };
+
+        Block* head = nullptr;
+        char* cursor = nullptr;
+        char* limit = nullptr;
+        size_t block_size;
+        size_t used = 0;
+        size_t blocks = 0;
+
+        void add_block(size_t minimum) {
+            size_t size = sizeof(Block) + (minimum > block_size ? minimum : block_size);
+            Block* block = static_cast<Block*>(malloc(size));
+            if (block == nullptr)
+                error("Out of memory");
+            block->previous = head;
+            head = block;
+            cursor = reinterpret_cast<char*>(block + 1);
+            limit = reinterpret_cast<char*>(block) + size;
+            ++blocks;
         }
+    };
 
-        char ahead(int skips = 0) {
-            size_t new_pointer = this->pointer + 1 + skips;
-            if (new_pointer >= this->length) 
-                new_pointer = this->length - 1;
-            return content[new_pointer];
+    //bildet jeden unterschiedlichen String genau einmal auf eine fortlaufende ID ab. Die Zeichen werden in die Arena kopiert,
+    //Namen können danach über ihre ID verglichen werden. ID 0 ist immer der leere String
+    class StringInterner final {
+    public:
+        explicit StringInterner(Arena& arena) : arena(arena) {
+            slots.assign(1024, 0);
+            intern(std::string_view());
         }
 
-        void parse_str_literal() {
-            Token token;
-            token.type = TokenType::STR_LITERAL;
-            std::stringstream string_builder;
-            //das erste Anführungszeichen entfernen
-            consume();
-            while (ahead() != '"') {
-                string_builder << consume();
+        StringInterner(const StringInterner&) = delete;
+        StringInterner& operator=(const StringInterner&) = delete;
+
+        uint32_t intern(std::string_view text) {
+            uint64_t hash = hash_bytes(text.data(), text.size());
+            size_t mask = slots.size() - 1;
+            size_t index = hash & mask;
+            while (slots[index] != 0) {
+                uint32_t id = slots[index] - 1;
+                if (hashes[id] == hash && strings[id] == text)
+                    return id;
+                index = (index + 1) & mask;
             }
-            //das beendende Anführungszeichen entfernen
-            consume();
-            TokenValue *value = new TokenValue();
-            value->str_value = new std::string(string_builder.str());
-            token.value = value;
-            this->tokens.push_back(token);
+            uint32_t id = static_cast<uint32_t>(strings.size());
+            strings.push_back(arena.copy(text));
+            hashes.push_back(hash);
+            slots[index] = id + 1;
+            //Lastfaktor unter 1/2 halten
+            if (strings.size() * 2 > slots.size())
+                grow();
+            return id;
         }
 
-        void parse_num_literal() {
-            Token token;
-            token.type = TokenType::NUM_LITERAL;
-            std::stringstream string_builder;
-            bool has_period = false;
-            while (Util::is_number(ahead()) || (!has_period && ahead() == '.')) {
-                char c = consume();
-                if (c == '.')
-                    has_period = true;
-                string_builder << c;
+        //liefert die ID, ohne den String aufzunehmen, oder UINT32_MAX falls er unbekannt ist
+        uint32_t find(std::string_view text) const {
+            uint64_t hash = hash_bytes(text.data(), text.size());
+            size_t mask = slots.size() - 1;
+            size_t index = hash & mask;
+            while (slots[index] != 0) {
+                uint32_t id = slots[index] - 1;
+                if (hashes[id] == hash && strings[id] == text)
+                    return id;
+                index = (index + 1) & mask;
             }
-            TokenValue *value = new TokenValue();
-            value->float_value = std::stof(string_builder.str());
-            token.value = value;
-            this->tokens.push_back(token);
+            return UINT32_MAX;
         }
 
-        //hat seine eigene Funktion, da Symbole wie Kommata, Semikolons etc innerhalb von Strings ignoriert und als Teil des Strings betrachtet werden müssen
-        void parse_string_literal() {
+        std::string_view get(uint32_t id) const {
+            return strings[id];
+        }
+
+        size_t size() const {
+            return strings.size();
+        }
+
+        //Werte der Number Literals, die nicht direkt in ein Token passen. Ohne Hash, die meisten kommen nur einmal vor
+        uint32_t add_number(double value) {
+            numbers.push_back(value);
+            return static_cast<uint32_t>(numbers.size() - 1);
+        }
+
+        double get_number(uint32_t index) const {
+            return numbers[index];
+        }
+
+        size_t number_count() const {
+            return numbers.size();
+        }
+
+    private:
+        Arena& arena;
+        std::vector<std::string_view> strings;
+        std::vector<uint64_t> hashes;
+        std::vector<double> numbers;
+        //offene Adressierung mit linearer Sondierung, gespeichert wird ID + 1, 0 bedeutet leer
+        std::vector<uint32_t> slots;
+
+        void grow() {
+            std::vector<uint32_t> new_slots(slots.size() * 2, 0);
+            size_t mask = new_slots.size() - 1;
+            for (uint32_t id = 0; id < strings.size(); ++id) {
+                size_t index = hashes[id] & mask;
+                while (new_slots[index] != 0)
+                    index = (index + 1) & mask;
+                new_slots[index] = id + 1;
+            }
+            slots.swap(new_slots);
+        }
+    };
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CORAL_X86_KERNELS 1
+#endif
+
+    enum SimdLevel {
+        SIMD_SCALAR,
+        SIMD_SSE2,
+        //AVX2 zusammen mit FMA, das gibt es praktisch nur gemeinsam
+        SIMD_AVX2
+    };
+
+    //die beste Stufe, die die CPU kann. Über die Umgebungsvariable CORAL_SIMD (scalar, sse2, avx2) lässt sich eine
+    //schwächere erzwingen, z.B. für Vergleichsmessungen
+    inline SimdLevel select_simd_level() {
+        SimdLevel level = SIMD_SCALAR;
+#ifdef CORAL_X86_KERNELS
+        const char* preference = getenv("CORAL_SIMD");
+        bool allow_sse2 = preference == nullptr || !str_equals(preference, "scalar");
+        bool allow_avx2 = allow_sse2 && (preference == nullptr || !str_equals(preference, "sse2"));
+        __builtin_cpu_init();
+        if (allow_sse2 && __builtin_cpu_supports("sse2"))
+            level = SIMD_SSE2;
+        if (allow_avx2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            level = SIMD_AVX2;
+#endif
+        return level;
+    }
+
+}
+
+//Fehlermeldungen mit Position im Quelltext. Gespeichert wird nur der Byte Offset, Zeile und Spalte werden erst beim Ausgeben
+//berechnet, fehlerfreie Durchläufe zahlen also nichts für die Zeilentabellen
+namespace Diagnostics {
+
+    enum class Severity : uint8_t {
+        NOTE,
+        WARNING,
+        ERROR
+    };
+
+    inline const char* severity_to_string(Severity severity) {
+        switch (severity) {
+            case Severity::NOTE: return "note";
+            case Severity::WARNING: return "warning";
+            default: return "error";
+        }
+    }
+
+    //Index der Datei in der Eingabeliste und Byte Offset in dieser Datei
+    struct Diagnostic {
+        Severity severity = Severity::ERROR;
+        uint32_t file = 0;
+        uint32_t offset = 0;
+        std::string message;
+    };
+
+    //nach so vielen Fehlern hört der Parser einer Datei auf, 0 bedeutet kein Limit
+    size_t error_limit = 20;
+
+    //Meldungen einer Datei oder eines Rumpfs. Jeder Thread schreibt nur in seine eigenen Listen
+    class DiagnosticList final {
+    public:
+        explicit DiagnosticList(uint32_t file = 0) : file(file) {
+        }
+
+        void report(Severity severity, uint32_t file, uint32_t offset, std::string message) {
+            if (severity == Severity::ERROR)
+                ++errors;
+            items.push_back({severity, file, offset, std::move(message)});
+        }
+
+        void error(uint32_t offset, std::string message) {
+            report(Severity::ERROR, file, offset, std::move(message));
+        }
+
+        void warning(uint32_t offset, std::string message) {
+            report(Severity::WARNING, file, offset, std::move(message));
+        }
+
+        void note(uint32_t offset, std::string message) {
+            report(Severity::NOTE, file, offset, std::move(message));
+        }
+
+        void set_file(uint32_t file) {
+            this->file = file;
+        }
+
+        size_t error_count() const {
+            return errors;
+        }
+
+        bool at_limit() const {
+            return error_limit != 0 && errors >= error_limit;
+        }
+
+        //der Parser hat am Fehlerlimit aufgehört, der Rest der Datei bzw. des Rumpfs ist ungeprüft
+        void stop_at_limit() {
+            add_stopped_file(file);
+        }
+
+        const std::vector<uint32_t>& get_stopped_files() const {
+            return stopped_files;
+        }
+
+        bool empty() const {
+            return items.empty();
+        }
+
+        const std::vector<Diagnostic>& get_items() const {
+            return items;
+        }
+
+        void append(const DiagnosticList& other) {
+            for (const Diagnostic& diagnostic : other.items)
+                report(diagnostic.severity, diagnostic.file, diagnostic.offset, diagnostic.message);
+            for (uint32_t stopped_file : other.stopped_files)
+                add_stopped_file(stopped_file);
+        }
+
+    private:
+        uint32_t file;
+        std::vector<Diagnostic> items;
+        //sortiert und ohne Duplikate, jeder Rumpf einer Datei kann das Limit melden
+        std::vector<uint32_t> stopped_files;
+
+        void add_stopped_file(uint32_t stopped_file) {
+            auto position = std::lower_bound(stopped_files.begin(), stopped_files.end(), stopped_file);
+            if (position == stopped_files.end() || *position != stopped_file)
+                stopped_files.insert(position, stopped_file);
+        }
+        size_t errors = 0;
+    };
+
+    //Zeilenanfänge einer Datei, wird erst für die erste Meldung in dieser Datei aufgebaut
+    class LineTable final {
+    public:
+        bool load(const std::string& path) {
+            if (!source.open(path.c_str()))
+                return false;
+            line_starts.push_back(0);
+            const char* data = source.data();
+            for (size_t i = 0; i < source.size(); ++i) {
+                if (data[i] == '\n')
+                    line_starts.push_back(static_cast<uint32_t>(i + 1));
+            }
+            return true;
+        }
+
+        //Zeile und Spalte beginnen bei 1
+        void locate(uint32_t offset, size_t& line, size_t& column) const {
+            size_t index = std::upper_bound(line_starts.begin(), line_starts.end(), offset) - line_starts.begin() - 1;
+            line = index + 1;
+            column = offset - line_starts[index] + 1;
+        }
+
+        std::string_view line_text(size_t line) const {
+            size_t start = line_starts[line - 1];
+            size_t end = line < line_starts.size() ? line_starts[line] : source.size();
+            while (end > start && (source.data()[end - 1] == '\n' || source.data()[end - 1] == '\r'))
+                --end;
+            return std::string_view(source.data() + start, end - start);
+        }
+
+    private:
+        Util::SourceBuffer source;
+        std::vector<uint32_t> line_starts;
+    };
+
+    //gibt die Meldungen in der gespeicherten Reihenfolge nach stderr aus, höchstens error_limit Fehler
+    void print(const std::vector<const DiagnosticList*>& lists, const std::vector<std::string>& paths) {
+        std::vector<std::unique_ptr<LineTable>> tables(paths.size());
+        std::vector<bool> loaded(paths.size(), false);
+        size_t printed_errors = 0, total_errors = 0;
+        for (const DiagnosticList* list : lists)
+            total_errors += list->error_count();
+        //wo der Parser am Fehlerlimit aufgehört hat, wurde der Rest nicht geprüft
+        auto print_stopped = [&]() {
+            std::vector<uint32_t> files;
+            for (const DiagnosticList* list : lists)
+                files.insert(files.end(), list->get_stopped_files().begin(), list->get_stopped_files().end());
+            std::sort(files.begin(), files.end());
+            files.erase(std::unique(files.begin(), files.end()), files.end());
+            for (uint32_t file : files) {
+                fprintf(stderr, "%s: note: stopped after %zu errors (--error-limit), the rest was not checked\n",
+                        file < paths.size() ? paths[file].c_str() : "coralc", error_limit);
+            }
+        };
+        for (const DiagnosticList* list : lists) {
+            for (const Diagnostic& diagnostic : list->get_items()) {
+                if (diagnostic.severity == Severity::ERROR) {
+                    if (error_limit != 0 && printed_errors >= error_limit) {
+                        fprintf(stderr, "too many errors emitted (%zu in total), stopping now\n", total_errors);
+                        print_stopped();
+                        return;
+                    }
+                    ++printed_errors;
+                }
+                if (diagnostic.file >= paths.size()) {
+                    fprintf(stderr, "%s: %s\n", severity_to_string(diagnostic.severity), diagnostic.message.c_str());
+                    continue;
+                }
+                if (!loaded[diagnostic.file]) {
+                    loaded[diagnostic.file] = true;
+                    tables[diagnostic.file].reset(new LineTable());
+                    if (!tables[diagnostic.file]->load(paths[diagnostic.file]))
+                        tables[diagnostic.file].reset();
+                }
+                const LineTable* table = tables[diagnostic.file].get();
+                if (table == nullptr) {
+                    fprintf(stderr, "%s: %s: %s\n", paths[diagnostic.file].c_str(), severity_to_string(diagnostic.severity), diagnostic.message.c_str());
+                    continue;
+                }
+                size_t line, column;
+                table->locate(diagnostic.offset, line, column);
+                std::string_view text = table->line_text(line);
+                fprintf(stderr, "%s:%zu:%zu: %s: %s\n", paths[diagnostic.file].c_str(), line, column, severity_to_string(diagnostic.severity), diagnostic.message.c_str());
+                fprintf(stderr, "    %.*s\n", static_cast<int>(text.size()), text.data());
+                //Tabs übernehmen, damit das ^ unter der richtigen Stelle steht
+                std::string marker;
+                for (size_t i = 0; i + 1 < column && i < text.size(); ++i)
+                    marker += text[i] == '\t' ? '\t' : ' ';
+                fprintf(stderr, "    %s^\n", marker.c_str());
+            }
+        }
+        print_stopped();
+    }
+
+}
+
+namespace Tokenization {
+
+    enum TokenType : uint8_t {
+        //zunächst werden alle Namen (die keine Zahl-, String-, oder Boolean Literals sind) zu Placeholdern.
+        //im nächsten Schritt werden diese dann durch entsprechende Keyword Tokens ersätzt
+        PLACEHOLDER = 0,
+        NUM_LITERAL = 1,
+        STR_LITERAL = 2,
+        BOOL_LITERAL = 3,
+        //Nutzerdefinierter identifier (Funktions-/Variablenname etc.)
+        NAME = 4,
+        //Funktionsdeklarationskeyword. Value ist gleich dem Rückgabewert
+        DECL_FUNCTION = 5,
+        //Keywords der Sprache
+        INTRINSIC = 6,
+        LINKED = 7,
+        NUM = 8,
+        STR = 9,
+        BOOL = 10,
+        //Zeichen
+        SEMICOLON = 11,
+        OPEN_CURLY = 12,
+        CLOSE_CURLY = 13,
+        OPEN_PARA = 14,
+        CLOSE_PARA = 15,
+        COMMA = 16,
+        PERIOD = 17,
+        EQUALS = 18,
+        //weitere keywords
+        TYPE = 19,
+        FROM = 20,
+        //Operatoren
+        PLUS = 21,
+        MINUS = 22,
+        STAR = 23,
+        SLASH = 24,
+        PERCENT = 25,
+        LESS = 26,
+        GREATER = 27,
+        BANG = 28,
+        EQUALS_EQUALS = 29,
+        NOT_EQUALS = 30,
+        LESS_EQUALS = 31,
+        GREATER_EQUALS = 32,
+        AND_AND = 33,
+        OR_OR = 34,
+        //Keywords für Funktionsrümpfe
+        RETURN = 35,
+        IF = 36,
+        ELSE = 37,
+        WHILE = 38,
+        NEW = 39,
+        THIS = 40,
+        NUMBERS = 41,
+        //Anzahl der Token Typen, muss immer der letzte Eintrag bleiben
+        TOKEN_TYPE_COUNT
+    };
+
+    //Anzeigenamen in der Reihenfolge von TokenType
+    constexpr const char* TOKEN_TYPE_NAMES[] = {
+        "Placeholder",
+        "Number Literal",
+        "String Literal",
+        "Boolean Literal",
+        "Name",
+        "Function Declaration",
+        "Intrinsic",
+        "Linked",
+        "Number Declaration",
+        "String Declaration",
+        "Boolean Declaration",
+        ";",
+        "{",
+        "}",
+        "(",
+        ")",
+        ",",
+        ".",
+        "Equals",
+        "Type",
+        "From",
+        "+",
+        "-",
+        "*",
+        "/",
+        "%",
+        "<",
+        ">",
+        "!",
+        "==",
+        "!=",
+        "<=",
+        ">=",
+        "&&",
+        "||",
+        "Return",
+        "If",
+        "Else",
+        "While",
+        "New",
+        "This",
+        "Numbers Declaration"
+    };
+
+    static_assert(sizeof(TOKEN_TYPE_NAMES) / sizeof(TOKEN_TYPE_NAMES[0]) == TOKEN_TYPE_COUNT, "every TokenType needs an entry in TOKEN_TYPE_NAMES");
+
+    const char* type_to_string(TokenType type) {
+        if (type >= TOKEN_TYPE_COUNT)
+            return "";
+        return TOKEN_TYPE_NAMES[type];
+    }
+
+    struct Keyword {
+        std::string_view spelling;
+        TokenType type;
+        //wird direkt als payload des Tokens übernommen
+        uint32_t payload;
+    };
+
+    //alle Schlüsselwörter der Sprache. Ein neues Keyword braucht nur einen Eintrag hier (und seinen TokenType),
+    //die Hash Tabelle wird zur Compilezeit daraus erzeugt. "function<typ>" ist kein Keyword, sondern ein Präfix
+    constexpr Keyword KEYWORDS[] = {
+        {"false", TokenType::BOOL_LITERAL, 0},
+        {"true", TokenType::BOOL_LITERAL, 1},
+        {"intrinsic", TokenType::INTRINSIC, 0},
+        {"linked", TokenType::LINKED, 0},
+        {"bool", TokenType::BOOL, 0},
+        {"string", TokenType::STR, 0},
+        {"number", TokenType::NUM, 0},
+        {"numbers", TokenType::NUMBERS, 0},
+        {"type", TokenType::TYPE, 0},
+        {"from", TokenType::FROM, 0},
+        {"return", TokenType::RETURN, 0},
+        {"if", TokenType::IF, 0},
+        {"else", TokenType::ELSE, 0},
+        {"while", TokenType::WHILE, 0},
+        {"new", TokenType::NEW, 0},
+        {"this", TokenType::THIS, 0}
+    };
+    constexpr int KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+    //perfekter Hash über Länge, erstes, zweites und letztes Zeichen eines Wortes. Das zweite Zeichen ist nötig,
+    //weil sich z.B. "true" und "type" in den anderen drei nicht unterscheiden
+    constexpr int KEYWORD_TABLE_BITS = 6;
+    constexpr int KEYWORD_TABLE_SIZE = 1 << KEYWORD_TABLE_BITS;
+
+    constexpr uint32_t keyword_hash(std::string_view word, uint32_t seed) {
+        uint32_t key = static_cast<uint32_t>(word.size())
+            | (static_cast<uint32_t>(static_cast<unsigned char>(word.front())) << 8)
+            | (static_cast<uint32_t>(static_cast<unsigned char>(word.size() > 1 ? word[1] : 0)) << 16)
+            | (static_cast<uint32_t>(static_cast<unsigned char>(word.back())) << 24);
+        key ^= key >> 13;
+        return (key * seed) >> (32 - KEYWORD_TABLE_BITS);
+    }
+
+    struct KeywordTable {
+        uint32_t seed = 0;
+        size_t min_length = 0;
+        size_t max_length = 0;
+        //Index in KEYWORDS oder -1
+        int8_t slots[KEYWORD_TABLE_SIZE] = {};
+    };
+
+    constexpr bool try_keyword_seed(KeywordTable& table, uint32_t seed) {
+        for (int i = 0; i < KEYWORD_TABLE_SIZE; ++i)
+            table.slots[i] = -1;
+        for (int i = 0; i < KEYWORD_COUNT; ++i) {
+            uint32_t slot = keyword_hash(KEYWORDS[i].spelling, seed);
+            if (table.slots[slot] != -1)
+                return false;
+            table.slots[slot] = static_cast<int8_t>(i);
+        }
+        table.seed = seed;
+        return true;
+    }
+
+    //probiert ungerade Multiplikatoren durch, bis keine zwei Keywords im gleichen Slot landen
+    constexpr KeywordTable make_keyword_table() {
+        KeywordTable table;
+        table.min_length = KEYWORDS[0].spelling.size();
+        for (int i = 0; i < KEYWORD_COUNT; ++i) {
+            size_t length = KEYWORDS[i].spelling.size();
+            if (length < table.min_length)
+                table.min_length = length;
+            if (length > table.max_length)
+                table.max_length = length;
+            for (int j = 0; j < i; ++j) {
+                if (KEYWORDS[i].spelling == KEYWORDS[j].spelling)
+                    return KeywordTable();
+            }
+        }
+        for (uint32_t seed = 0x9E3779B1u; seed < 0x9E3779B1u + 8192u; seed += 2) {
+            if (try_keyword_seed(table, seed))
+                return table;
+        }
+        return KeywordTable();
+    }
+
+    constexpr KeywordTable KEYWORD_TABLE = make_keyword_table();
+
+    static_assert(KEYWORD_TABLE.seed != 0, "KEYWORDS contains duplicates or no perfect hash seed was found");
+
+    //O(1): ein Tabellenzugriff und ein memcmp
+    inline const Keyword* find_keyword(std::string_view word) {
+        if (word.size() < KEYWORD_TABLE.min_length || word.size() > KEYWORD_TABLE.max_length)
+            return nullptr;
+        uint32_t slot = keyword_hash(word, KEYWORD_TABLE.seed);
+        int index = KEYWORD_TABLE.slots[slot];
+        if (index < 0)
+            return nullptr;
+        const Keyword& keyword = KEYWORDS[index];
+        if (keyword.spelling.size() != word.size() || memcmp(keyword.spelling.data(), word.data(), word.size()) != 0)
+            return nullptr;
+        return &keyword;
+    }
+
+    //Tokens sind 12 Byte groß und enthalten keine Zeiger. Die Bedeutung von payload hängt vom Typ ab:
+    //Namen, String Literals und Funktionsdeklarationen -> ID im StringInterner
+    //Number Literals -> ganze Zahlen unter 2^31 direkt, sonst NUMBER_INTERNED | Index in die Zahlen des StringInterners
+    //Boolean Literals -> 0 oder 1
+    struct Token {
+        TokenType type = TokenType::PLACEHOLDER;
+        uint32_t payload = 0;
+        //Byte Offset des ersten Zeichens in der Quelldatei, für Fehlermeldungen
+        uint32_t offset = 0;
+    };
+
+    static_assert(sizeof(Token) == 12, "Token should stay 12 bytes");
+
+    inline std::string_view get_str_value(const Util::StringInterner& interner, const Token& token) {
+        return interner.get(token.payload);
+    }
+
+    constexpr uint32_t NUMBER_INTERNED = 0x80000000u;
+
+    inline double get_number_value(const Util::StringInterner& interner, const Token& token) {
+        if (!(token.payload & NUMBER_INTERNED))
+            return token.payload;
+        return interner.get_number(token.payload & ~NUMBER_INTERNED);
+    }
+
+    inline bool get_bool_value(const Token& token) {
+        return token.payload != 0;
+    }
+
+    inline uint32_t number_to_payload(Util::StringInterner& interner, double value) {
+        if (value >= 0 && value < NUMBER_INTERNED && value == static_cast<uint32_t>(value) && !std::signbit(value))
+            return static_cast<uint32_t>(value);
+        return NUMBER_INTERNED | interner.add_number(value);
+    }
+
+    struct NumberLiteral {
+        double value = 0;
+        //exakter Wert bei ganzen Zahlen
+        uint64_t integer = 0;
+        bool is_integer = false;
+        //die ganze Zahl passt nicht genau in einen double und wurde gerundet
+        bool is_rounded = false;
+    };
+
+    inline bool is_digit_in_base(char c, int base) {
+        if (base == 16)
+            return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+        return c >= '0' && c < '0' + base;
+    }
+
+    //ein Durchlauf ohne Allokation und unabhängig von der Locale: 123, 1_000, 1.5, 2.5e-3, 0x1F und 0b1010. Unterstriche
+    //nur zwischen zwei Ziffern. Gibt eine Fehlermeldung zurück oder nullptr
+    inline const char* parse_number_literal(std::string_view text, NumberLiteral& result) {
+        int base = 10;
+        size_t i = 0;
+        if (text.size() > 1 && text[0] == '0' && ((text[1] | 0x20) == 'x' || (text[1] | 0x20) == 'b')) {
+            base = (text[1] | 0x20) == 'x' ? 16 : 2;
+            i = 2;
+        }
+        //from_chars kennt keine Unterstriche, die Ziffern werden dafür auf den Stack kopiert
+        char digits[128];
+        size_t count = 0;
+        bool is_integer = true;
+        char previous = '\0';
+        for (; i < text.size(); ++i) {
+            char c = text[i];
+            if (c == '_') {
+                if (!is_digit_in_base(previous, base) || i + 1 == text.size() || !is_digit_in_base(text[i + 1], base))
+                    return "Underscores in number literals are only allowed between digits";
+                previous = c;
+                continue;
+            }
+            if (base == 10 && (c == '.' || (c | 0x20) == 'e' || ((c == '+' || c == '-') && (previous | 0x20) == 'e')))
+                is_integer = false;
+            else if (!is_digit_in_base(c, base))
+                return "Invalid digit in number literal";
+            if (count == sizeof(digits))
+                return "Number literal is too long";
+            digits[count++] = c;
+            previous = c;
+        }
+        if (count == 0)
+            return "Number literal has no digits";
+
+        result = NumberLiteral();
+        result.is_integer = is_integer;
+        if (is_integer) {
+            std::from_chars_result parsed = std::from_chars(digits, digits + count, result.integer, base);
+            if (parsed.ec == std::errc()) {
+                result.value = static_cast<double>(result.integer);
+                result.is_rounded = result.value >= 18446744073709551616.0 || static_cast<uint64_t>(result.value) != result.integer;
+                return nullptr;
+            }
+            if (base != 10)
+                return "Number literal does not fit into 64 bits";
+            //größere Dezimalzahlen werden wie Kommazahlen korrekt gerundet
+            result.is_rounded = true;
+        }
+        std::from_chars_result parsed = std::from_chars(digits, digits + count, result.value);
+        if (parsed.ec == std::errc::result_out_of_range)
+            return "Number literal is out of range";
+        if (parsed.ec != std::errc() || parsed.ptr != digits + count)
+            return "Invalid number literal";
+        return nullptr;
+    }
+
+    struct SymbolToken {
+        char first;
+        //'\0' bei Symbolen aus einem Zeichen
+        char second;
+        TokenType type;
+    };
+
+    //Symbole aus einem oder zwei Zeichen. '&' und '|' sind nur doppelt gültig, einzeln werden sie zu Placeholdern
+    constexpr SymbolToken SYMBOL_TOKENS[] = {
+        {';', '\0', TokenType::SEMICOLON},
+        {'{', '\0', TokenType::OPEN_CURLY},
+        {'}', '\0', TokenType::CLOSE_CURLY},
+        {'(', '\0', TokenType::OPEN_PARA},
+        {')', '\0', TokenType::CLOSE_PARA},
+        {',', '\0', TokenType::COMMA},
+        {'.', '\0', TokenType::PERIOD},
+        {'=', '\0', TokenType::EQUALS},
+        {'+', '\0', TokenType::PLUS},
+        {'-', '\0', TokenType::MINUS},
+        {'*', '\0', TokenType::STAR},
+        {'/', '\0', TokenType::SLASH},
+        {'%', '\0', TokenType::PERCENT},
+        {'<', '\0', TokenType::LESS},
+        {'>', '\0', TokenType::GREATER},
+        {'!', '\0', TokenType::BANG},
+        {'&', '\0', TokenType::PLACEHOLDER},
+        {'|', '\0', TokenType::PLACEHOLDER},
+        {'=', '=', TokenType::EQUALS_EQUALS},
+        {'!', '=', TokenType::NOT_EQUALS},
+        {'<', '=', TokenType::LESS_EQUALS},
+        {'>', '=', TokenType::GREATER_EQUALS},
+        {'&', '&', TokenType::AND_AND},
+        {'|', '|', TokenType::OR_OR}
+    };
+    constexpr int SYMBOL_TOKEN_COUNT = sizeof(SYMBOL_TOKENS) / sizeof(SYMBOL_TOKENS[0]);
+
+    enum CharClass : uint8_t {
+        CHAR_WHITESPACE = 1,
+        CHAR_DIGIT = 2,
+        CHAR_SYMBOL = 4,
+        //darf in einem Namen vorkommen (alles außer Whitespace und Symbolen)
+        CHAR_NAME = 8,
+        CHAR_QUOTE = 16
+    };
+
+    //Lookup Tabellen mit je einem Eintrag pro Byte, damit der Tokenizer jedes Zeichen mit einem einzigen Zugriff klassifizieren kann
+    struct CharTables {
+        uint8_t classes[256];
+        TokenType symbol_types[256];
+        //Typ des Symbols aus zwei Zeichen, das mit diesem Zeichen beginnt, und das nötige zweite Zeichen
+        TokenType pair_types[256];
+        char pair_seconds[256];
+    };
+
+    constexpr CharTables make_char_tables() {
+        CharTables tables{};
+        for (int c = 0; c < 256; ++c) {
+            tables.classes[c] = CHAR_NAME;
+            tables.symbol_types[c] = TokenType::PLACEHOLDER;
+            tables.pair_types[c] = TokenType::PLACEHOLDER;
+            tables.pair_seconds[c] = '\0';
+        }
+        const char whitespace[] = {' ', '\t', '\n', '\v', '\f', '\r'};
+        for (char c : whitespace)
+            tables.classes[static_cast<unsigned char>(c)] = CHAR_WHITESPACE;
+        for (int c = '0'; c <= '9'; ++c)
+            tables.classes[c] = CHAR_NAME | CHAR_DIGIT;
+        tables.classes[static_cast<unsigned char>('"')] = CHAR_NAME | CHAR_QUOTE;
+        for (int i = 0; i < SYMBOL_TOKEN_COUNT; ++i) {
+            unsigned char c = static_cast<unsigned char>(SYMBOL_TOKENS[i].first);
+            tables.classes[c] = CHAR_SYMBOL;
+            if (SYMBOL_TOKENS[i].second == '\0') {
+                tables.symbol_types[c] = SYMBOL_TOKENS[i].type;
+            } else {
+                tables.pair_types[c] = SYMBOL_TOKENS[i].type;
+                tables.pair_seconds[c] = SYMBOL_TOKENS[i].second;
+            }
+        }
+        return tables;
+    }
+
+    constexpr CharTables CHAR_TABLES = make_char_tables();
+
+    inline uint8_t char_class(char c) {
+        return CHAR_TABLES.classes[static_cast<unsigned char>(c)];
+    }
+
+    inline bool is_symbol(char c) {
+        return (char_class(c) & CHAR_SYMBOL) != 0;
+    }
+
+    inline TokenType get_symbol_type(char c) {
+        return CHAR_TABLES.symbol_types[static_cast<unsigned char>(c)];
+    }
+
+    //liefert den Typ des Symbols aus den Zeichen first und second oder PLACEHOLDER, wenn es kein solches Symbol gibt
+    inline TokenType get_symbol_pair_type(char first, char second) {
+        unsigned char index = static_cast<unsigned char>(first);
+        if (CHAR_TABLES.pair_seconds[index] != second || second == '\0')
+            return TokenType::PLACEHOLDER;
+        return CHAR_TABLES.pair_types[index];
+    }
+
+    //Scan Kernels für die heißen Schleifen des Tokenizers. Jeder Kernel liefert einen Zeiger auf das erste Zeichen,
+    //das nicht mehr zur gesuchten Klasse gehört, bzw. end. Die Vektorversionen prüfen 16 oder 32 Bytes pro Schritt
+    //und überlassen den Rest der Skalarversion
+    inline bool is_simple_name_char(unsigned char c) {
+        return static_cast<unsigned>((c | 0x20) - 'a') <= 'z' - 'a' || static_cast<unsigned>(c - '0') <= 9u || c == '_';
+    }
+
+    const char* skip_whitespace_scalar(const char* begin, const char* end) {
+        while (begin < end && (char_class(*begin) & CHAR_WHITESPACE))
+            ++begin;
+        return begin;
+    }
+
+    //überspringt nur [A-Za-z0-9_], alle anderen Namenszeichen (z.B. die spitzen Klammern in "function<number>")
+    //behandelt der Tokenizer selbst über die Tabelle
+    const char* skip_simple_name_scalar(const char* begin, const char* end) {
+        while (begin < end && is_simple_name_char(static_cast<unsigned char>(*begin)))
+            ++begin;
+        return begin;
+    }
+
+    const char* find_quote_scalar(const char* begin, const char* end) {
+        const void* quote = memchr(begin, '"', end - begin);
+        return quote == nullptr ? end : static_cast<const char*>(quote);
+    }
+
+#ifdef CORAL_X86_KERNELS
+
+    //x liegt in [low, low + span] (vorzeichenlos), SSE2 hat dafür keinen direkten Vergleich
+    __attribute__((target("sse2")))
+    inline __m128i in_range_sse2(__m128i x, char low, char span) {
+        __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8(low));
+        return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(span)), shifted);
+    }
+
+    __attribute__((target("sse2")))
+    const char* skip_whitespace_sse2(const char* begin, const char* end) {
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            //' ' sowie \t \n \v \f \r (0x09 bis 0x0D)
+            __m128i whitespace = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), in_range_sse2(chunk, '\t', '\r' - '\t'));
+            unsigned mask = ~_mm_movemask_epi8(whitespace) & 0xFFFF;
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 16;
+        }
+        return skip_whitespace_scalar(begin, end);
+    }
+
+    __attribute__((target("sse2")))
+    const char* skip_simple_name_sse2(const char* begin, const char* end) {
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i letters = in_range_sse2(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), 'a', 'z' - 'a');
+            __m128i digits = in_range_sse2(chunk, '0', 9);
+            __m128i underscores = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_'));
+            unsigned mask = ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscores)) & 0xFFFF;
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 16;
+        }
+        return skip_simple_name_scalar(begin, end);
+    }
+
+    __attribute__((target("sse2")))
+    const char* find_quote_sse2(const char* begin, const char* end) {
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 16;
+        }
+        return find_quote_scalar(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i in_range_avx2(__m256i x, char low, char span) {
+        __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(low));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(span)), shifted);
+    }
+
+    __attribute__((target("avx2")))
+    const char* skip_whitespace_avx2(const char* begin, const char* end) {
+        while (end - begin >= 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i whitespace = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), in_range_avx2(chunk, '\t', '\r' - '\t'));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(whitespace));
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 32;
+        }
+        return skip_whitespace_sse2(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char* skip_simple_name_avx2(const char* begin, const char* end) {
+        while (end - begin >= 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i letters = in_range_avx2(_mm256_or_si256(chunk, _mm256_set1_epi8(0x20)), 'a', 'z' - 'a');
+            __m256i digits = in_range_avx2(chunk, '0', 9);
+            __m256i underscores = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_'));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letters, digits), underscores)));
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 32;
+        }
+        return skip_simple_name_sse2(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char* find_quote_avx2(const char* begin, const char* end) {
+        while (end - begin >= 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))));
+            if (mask != 0)
+                return begin + __builtin_ctz(mask);
+            begin += 32;
+        }
+        return find_quote_sse2(begin, end);
+    }
+#endif
+
+    struct ScanKernels {
+        const char* name;
+        const char* (*skip_whitespace)(const char* begin, const char* end);
+        const char* (*skip_simple_name)(const char* begin, const char* end);
+        const char* (*find_quote)(const char* begin, const char* end);
+    };
+
+    //wählt die Kernels einmalig anhand von Util::select_simd_level aus
+    ScanKernels select_scan_kernels() {
+        ScanKernels kernels = {"scalar", skip_whitespace_scalar, skip_simple_name_scalar, find_quote_scalar};
+#ifdef CORAL_X86_KERNELS
+        Util::SimdLevel level = Util::select_simd_level();
+        if (level >= Util::SIMD_SSE2)
+            kernels = {"sse2", skip_whitespace_sse2, skip_simple_name_sse2, find_quote_sse2};
+        if (level >= Util::SIMD_AVX2)
+            kernels = {"avx2", skip_whitespace_avx2, skip_simple_name_avx2, find_quote_avx2};
+#endif
+        return kernels;
+    }
+
+    const ScanKernels& scan_kernels() {
+        static const ScanKernels kernels = select_scan_kernels();
+        return kernels;
+    }
+
+    
+    void print_token(const Util::StringInterner& interner, const Tokenization::Token& token) {
+        Util::log(Util::TRACE, "==========\n");
+        Util::log(Util::TRACE, "Type: ");
+        Util::log(Util::TRACE, "%s", type_to_string(token.type));
+        Util::log(Util::TRACE, "\n");
+        switch (token.type) {
+            case Tokenization::TokenType::STR_LITERAL:
+            case Tokenization::TokenType::NAME:
+            case Tokenization::TokenType::DECL_FUNCTION:
+            case Tokenization::TokenType::PLACEHOLDER: {
+                std::string_view value = get_str_value(interner, token);
+                Util::log(Util::TRACE, "value: %.*s\n", static_cast<int>(value.size()), value.data());
+                break;
+            }
+            case Tokenization::TokenType::NUM_LITERAL:
+                Util::log(Util::TRACE, "value: %.17g\n", get_number_value(interner, token));
+                break;
+            case Tokenization::TokenType::BOOL_LITERAL:
+                Util::log(Util::TRACE, "value: %s\n", Util::bool_to_str(get_bool_value(token)));
+                break;
+            default:
+                break;
+        }
+    }
+
+    //Quelle, aus der der Parser seine Tokens zieht
+    class TokenSource {
+    public:
+        virtual ~TokenSource() = default;
+
+        //liefert das nächste Token, false am Dateiende
+        virtual bool next(Token& token) = 0;
+    };
+
+    //für bereits vollständig vorliegende Token Listen
+    class VectorTokenSource final : public TokenSource {
+    public:
+        VectorTokenSource(const std::vector<Token>& tokens) : tokens(tokens) {
+        }
+
+        bool next(Token& token) override {
+            if (pointer >= tokens.size())
+                return false;
+            token = tokens[pointer++];
+            return true;
+        }
+
+    private:
+        const std::vector<Token>& tokens;
+        size_t pointer = 0;
+    };
+
+    class Tokenizer final : public TokenSource {
+    public:
+        //der Tokenizer liest direkt aus dem übergebenen Puffer. Namen und Strings landen im Interner, die Tokens
+        //verweisen also nicht mehr in den Quelltext
+        Tokenizer(std::string_view content, Util::StringInterner& interner, Diagnostics::DiagnosticList* diagnostics = nullptr) : interner(interner) {
+            this->cursor = content.data();
+            this->end = content.data() + content.size();
+            this->window = content.data();
+            this->diagnostics = diagnostics;
+            Util::log(Util::TRACE, "created tokenizer\ncontent is: \n%.*s\n", static_cast<int>(content.size()), content.data());
+        }
+
+        //Streaming Modus: die Quelle wird blockweise gelesen, es liegt nie die ganze Datei im Speicher
+        Tokenizer(Util::ChunkedReader& reader, Util::StringInterner& interner, Diagnostics::DiagnosticList* diagnostics = nullptr) : interner(interner) {
+            this->reader = &reader;
+            this->diagnostics = diagnostics;
+            Util::log(Util::TRACE, "created streaming tokenizer\n");
+        }
+
+        bool next(Token& token) override {
+            while (true) {
+                if (cursor == end && !refill(cursor))
+                    return false;
+                uint8_t current_class = char_class(*cursor);
+                if (current_class & CHAR_WHITESPACE) {
+                    cursor = kernels.skip_whitespace(cursor, end);
+                } else if (*cursor == '/' && starts_comment()) {
+                    skip_comment();
+                } else if (current_class & CHAR_QUOTE) {
+                    uint32_t offset = offset_of(cursor);
+                    token = parse_string_literal();
+                    token.offset = offset;
+                    ++produced;
+                    return true;
+                } else if (current_class & CHAR_DIGIT) {
+                    uint32_t offset = offset_of(cursor);
+                    token = parse_number();
+                    token.offset = offset;
+                    ++produced;
+                    return true;
+                } else {
+                    uint32_t offset = offset_of(cursor);
+                    token = parse_name_or_symbol();
+                    token.offset = offset;
+                    ++produced;
+                    return true;
+                }
+            }
+        }
+
+        std::vector<Token> tokenize() {
+            //grobe Schätzung, damit der Vektor beim Tokenisieren nur selten wachsen muss
+            tokens.reserve((end - cursor) / 6 + 16);
+            Token token;
+            while (next(token))
+                tokens.push_back(token);
+            return tokens;
+        }
+
+        void print_all_tokens() {
+            Util::log(Util::TRACE, "token count %zu\n", tokens.size());
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                print_token(interner, tokens[i]);
+            }
+            Util::log(Util::TRACE, "\n");
+        }
+
+        size_t token_count() const {
+            return produced;
+        }
+
+
+    private:
+        const char* cursor = nullptr;
+        const char* end = nullptr;
+        //nur im Streaming Modus gesetzt
+        Util::ChunkedReader* reader = nullptr;
+        //Anfang des aktuellen Fensters und dessen Position in der Datei, daraus ergeben sich die Offsets der Tokens
+        const char* window = nullptr;
+        uint64_t window_offset = 0;
+        //ohne Liste sind Fehler des Tokenizers fatal
+        Diagnostics::DiagnosticList* diagnostics = nullptr;
+        std::vector<Token> tokens;
+        size_t produced = 0;
+        Util::StringInterner& interner;
+        const ScanKernels& kernels = scan_kernels();
+
+        //lädt im Streaming Modus den nächsten Block. Alles ab token_start bleibt erhalten, token_start und cursor
+        //zeigen danach auf die gleichen Zeichen im neuen Fenster
+        bool refill(const char*& token_start) {
+            if (reader == nullptr)
+                return false;
+            size_t cursor_offset = cursor - token_start;
+            bool has_more = reader->refill(token_start);
+            token_start = reader->data();
+            cursor = token_start + cursor_offset;
+            end = reader->data() + reader->size();
+            window = reader->data();
+            window_offset = reader->offset();
+            return has_more;
+        }
+
+        uint32_t offset_of(const char* position) const {
+            return static_cast<uint32_t>(window_offset + (position - window));
+        }
+
+        //liefert das Zeichen hinter cursor, lädt dafür im Streaming Modus notfalls nach. '\0' am Dateiende
+        char peek_next(const char*& token_start) {
+            if (cursor + 1 >= end)
+                refill(token_start);
+            return cursor + 1 < end ? cursor[1] : '\0';
+        }
+
+        bool starts_comment() {
+            const char* start = cursor;
+            return peek_next(start) == '/';
+        }
+
+        //Zeilenkommentare mit //
+        void skip_comment() {
+            while (true) {
+                const void* newline = memchr(cursor, '\n', end - cursor);
+                if (newline != nullptr) {
+                    cursor = static_cast<const char*>(newline) + 1;
+                    return;
+                }
+                cursor = end;
+                if (!refill(cursor))
+                    return;
+            }
+        }
+
+        //hat seine eigene Funktion, da Symbole wie Kommata, Semikolons etc innerhalb von Strings ignoriert und als Teil des Strings betrachtet werden müssen
+        Token parse_string_literal() {
             //erstes Anführungszeichen entfernen
+            const char* start = ++cursor;
+            const char* quote = kernels.find_quote(cursor, end);
+            while (quote == end) {
+                cursor = end;
+                if (!refill(start)) {
+                    if (diagnostics == nullptr)
+                        Util::error("Reached end of file while parsing string literal");
+                    //der Rest der Datei wird zum String, der Parser meldet danach höchstens noch das Dateiende
+                    diagnostics->error(offset_of(start) - 1, "Reached end of file while parsing string literal");
+                    //refill hat den Puffer eventuell verschoben
+                    quote = end;
+                    break;
+                }
+                quote = kernels.find_quote(cursor, end);
+            }
+            Token token;
+            token.type = TokenType::STR_LITERAL;
+            token.payload = interner.intern(std::string_view(start, quote - start));
+            //Anführungszeichen am Ende entfernen
+            cursor = quote == end ? end : quote + 1;
+            return token;
+        }
+
+        //'<' ist ein Symbol, der Rückgabetyp in "function<typ>" gehört aber noch zum Wort
+        void scan_return_type(const char*& start) {
+            if (cursor == end && !refill(start))
+                return;
+            if (*cursor != '<')
+                return;
+            while (true) {
+                const void* closing = memchr(cursor, '>', end - cursor);
+                if (closing != nullptr) {
+                    cursor = static_cast<const char*>(closing) + 1;
+                    return;
+                }
+                cursor = end;
+                if (!refill(start)) {
+                    if (diagnostics == nullptr)
+                        Util::error("Reached end of file while parsing a function declaration");
+                    diagnostics->error(offset_of(start), "Reached end of file while parsing a function declaration");
+                    return;
+                }
+            }
+        }
+
+        Token parse_name_or_symbol() {
+            Token token;
+            const char* start = cursor;
+            char c = *cursor;
+            if (is_symbol(c)) {
+                TokenType pair_type = get_symbol_pair_type(c, peek_next(start));
+                if (pair_type != TokenType::PLACEHOLDER) {
+                    token.type = pair_type;
+                    cursor += 2;
+                } else {
+                    token.type = get_symbol_type(c);
+                    cursor += 1;
+                }
+                return token;
+            }
+            ++cursor;
+            while (true) {
+                cursor = kernels.skip_simple_name(cursor, end);
+                if (cursor == end) {
+                    //der Name könnte im nächsten Block weitergehen
+                    if (refill(start))
+                        continue;
+                    break;
+                }
+                if (!(char_class(*cursor) & CHAR_NAME))
+                    break;
+                ++cursor;
+            }
+            if (c == 'f' && cursor - start == 8 && memcmp(start, "function", 8) == 0)
+                scan_return_type(start);
+            std::string_view value(start, cursor - start);
+            //printf("got name token with value %s\n", value);
+            const Keyword* keyword = find_keyword(value);
+            if (keyword != nullptr) {
+                token.type = keyword->type;
+                token.payload = keyword->payload;
+            } else if (c == 'f' && Util::str_starts_with(value, "function")) {
+                //"function<typ>": der Wert ist der Rückgabetyp zwischen den spitzen Klammern
+                token.type = TokenType::DECL_FUNCTION;
+                if (value.size() >= 10)
+                    token.payload = interner.intern(value.substr(9, value.size() - 10));
+            } else {
+                token.type = TokenType::NAME;
+                token.payload = interner.intern(value);
+            }
+            return token;
+        }
+
+        //eine Zahl endet wie ein Name an Leerzeichen und Symbolen, dazu gehören aber noch ein Punkt vor einer Ziffer und
+        //das Vorzeichen eines Exponenten. Ob die Zeichen eine gültige Zahl ergeben, entscheidet parse_number_literal
+        Token parse_number() {
+            Token token;
+            token.type = TokenType::NUM_LITERAL;
+            const char* start = cursor;
+            char second = peek_next(start) | 0x20;
+            bool is_decimal = !(*start == '0' && (second == 'x' || second == 'b'));
+            bool has_period = false;
+            ++cursor;
+            while (true) {
+                cursor = kernels.skip_simple_name(cursor, end);
+                if (cursor == end) {
+                    if (refill(start))
+                        continue;
+                    break;
+                }
+                char c = *cursor;
+                if (is_decimal && ((c == '.' && !has_period) || ((c == '+' || c == '-') && (cursor[-1] | 0x20) == 'e'))
+                        && (char_class(peek_next(start)) & CHAR_DIGIT)) {
+                    has_period |= c == '.';
+                    ++cursor;
+                    continue;
+                }
+                if (!(char_class(c) & CHAR_NAME))
+                    break;
+                ++cursor;
+            }
+            NumberLiteral literal;
+            const char* message = parse_number_literal(std::string_view(start, cursor - start), literal);
+            if (message != nullptr) {
+                if (diagnostics == nullptr)
+                    Util::error(message);
+                diagnostics->error(offset_of(start), message);
+                return token;
+            }
+            if (literal.is_rounded && diagnostics != nullptr) {
+                char rounded[64];
+                snprintf(rounded, sizeof(rounded), "%.0f", literal.value);
+                diagnostics->warning(offset_of(start), std::string("Integer literal is not exactly representable as a number and is rounded to ") + rounded);
+            }
+            token.payload = number_to_payload(interner, literal.value);
+            return token;
+        }
+
+    };
+}
+
+namespace Parsing {
+
+    using namespace Tokenization;
+
+    constexpr uint32_t NO_SYMBOL = UINT32_MAX;
+
+    enum class SymbolKind : uint8_t {
+        TYPE,
+        FIELD,
+        FUNCTION,
+        MEMBER_FUNCTION,
+        GLOBAL_VAR,
+        PARAMETER,
+        LOCAL_VAR
+    };
+
+    enum class ScopeKind : uint8_t {
+        GLOBAL,
+        TYPE_MEMBER,
+        FUNCTION,
+        BLOCK
+    };
+
+    struct Symbol {
+        //ID im StringInterner
+        uint32_t name;
+        SymbolKind kind;
+        //Scope, in dem das Symbol deklariert wurde
+        uint32_t scope;
+        //Index in die zur Art passende Tabelle (types, functions, global_vars, fields des Typs ...)
+        uint32_t index;
+    };
+
+    //Symboltabelle mit verschachtelten Scopes. Alle Scopes teilen sich eine Hash Tabelle mit offener Adressierung,
+    //Schlüssel ist (Scope, Namens-ID). Symbole und Scopes werden nie entfernt, ihre IDs bleiben also für spätere Phasen gültig
+    class SymbolTable final {
+    public:
+        static constexpr uint32_t GLOBAL_SCOPE = 0;
+
+        SymbolTable() {
+            slots.assign(256, 0);
+            scopes.push_back({ScopeKind::GLOBAL, NO_SYMBOL});
+        }
+
+        //legt einen neuen Scope unterhalb von parent an, ohne ihn zu betreten
+        uint32_t create_scope(ScopeKind kind, uint32_t parent) {
+            scopes.push_back({kind, parent});
+            return static_cast<uint32_t>(scopes.size() - 1);
+        }
+
+        uint32_t enter_scope(ScopeKind kind) {
+            active_scope = create_scope(kind, active_scope);
+            return active_scope;
+        }
+
+        //betritt einen bereits angelegten Scope, z.B. den Member Scope eines Typs
+        void reenter_scope(uint32_t scope) {
+            active_scope = scope;
+        }
+
+        void exit_scope() {
+            active_scope = scopes[active_scope].parent;
+        }
+
+        uint32_t current_scope() const {
+            return active_scope;
+        }
+
+        ScopeKind scope_kind(uint32_t scope) const {
+            return scopes[scope].kind;
+        }
+
+        uint32_t scope_parent(uint32_t scope) const {
+            return scopes[scope].parent;
+        }
+
+        //liefert die ID des neuen Symbols oder NO_SYMBOL, wenn der Name im aktuellen Scope schon vergeben ist
+        uint32_t declare(uint32_t name, SymbolKind kind, uint32_t index) {
+            return declare_in_scope(active_scope, name, kind, index);
+        }
+
+        uint32_t declare_in_scope(uint32_t scope, uint32_t name, SymbolKind kind, uint32_t index) {
+            size_t slot = find_slot(scope, name);
+            if (slots[slot] != 0)
+                return NO_SYMBOL;
+            uint32_t id = static_cast<uint32_t>(symbols.size());
+            symbols.push_back({name, kind, scope, index});
+            slots[slot] = id + 1;
+            //Lastfaktor unter 1/2 halten
+            if (symbols.size() * 2 > slots.size())
+                grow();
+            return id;
+        }
+
+        //sucht vom aktuellen Scope nach außen
+        uint32_t lookup(uint32_t name) const {
+            for (uint32_t scope = active_scope; scope != NO_SYMBOL; scope = scopes[scope].parent) {
+                uint32_t id = lookup_in_scope(scope, name);
+                if (id != NO_SYMBOL)
+                    return id;
+            }
+            return NO_SYMBOL;
+        }
+
+        uint32_t lookup_in_scope(uint32_t scope, uint32_t name) const {
+            uint32_t entry = slots[find_slot(scope, name)];
+            return entry == 0 ? NO_SYMBOL : entry - 1;
+        }
+
+        const Symbol& get(uint32_t id) const {
+            return symbols[id];
+        }
+
+        size_t symbol_count() const {
+            return symbols.size();
+        }
+
+        size_t scope_count() const {
+            return scopes.size();
+        }
+
+    private:
+        struct Scope {
+            ScopeKind kind;
+            uint32_t parent;
+        };
+
+        std::vector<Symbol> symbols;
+        std::vector<Scope> scopes;
+        uint32_t active_scope = GLOBAL_SCOPE;
+        //gespeichert wird Symbol ID + 1, 0 bedeutet leer
+        std::vector<uint32_t> slots;
+
+        static uint64_t key_hash(uint32_t scope, uint32_t name) {
+            return Util::mix_hash((static_cast<uint64_t>(scope) << 32) | name);
+        }
+
+        size_t find_slot(uint32_t scope, uint32_t name) const {
+            size_t mask = slots.size() - 1;
+            size_t index = key_hash(scope, name) & mask;
+            while (slots[index] != 0) {
+                const Symbol& symbol = symbols[slots[index] - 1];
+                if (symbol.scope == scope && symbol.name == name)
+                    break;
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        void grow() {
+            std::vector<uint32_t> new_slots(slots.size() * 2, 0);
+            size_t mask = new_slots.size() - 1;
+            for (uint32_t id = 0; id < symbols.size(); ++id) {
+                size_t index = key_hash(symbols[id].scope, symbols[id].name) & mask;
+                while (new_slots[index] != 0)
+                    index = (index + 1) & mask;
+                new_slots[index] = id + 1;
+            }
+            slots.swap(new_slots);
+        }
+    };
+
+    //statischer Typ eines Werts. Objekttypen verweisen über type_index in ParseInfo::types
+    struct ValueType {
+        enum Kind : uint8_t {
+            VOID,
+            NUMBER,
+            STRING,
+            BOOL,
+            //Feld von Zahlen, nur über intrinsic Funktionen zugänglich
+            NUMBERS,
+            OBJECT,
+            //für Namen, deren Typ nicht aufgelöst werden konnte. Passt zu allem, damit ein Fehler keine Folgefehler erzeugt
+            ERROR
+        };
+
+        Kind kind = VOID;
+        int type_index = -1;
+
+        bool operator==(const ValueType& other) const {
+            return kind == other.kind && type_index == other.type_index;
+        }
+
+        bool operator!=(const ValueType& other) const {
+            return !(*this == other);
+        }
+    };
+
+    struct FieldInfo {
+        std::string name;
+        std::string type;
+        //Offset des Namens in der Quelldatei des Typs
+        uint32_t offset = 0;
+        uint32_t symbol = NO_SYMBOL;
+        //mit hot markierte Felder kommen möglichst in die erste Cache Line des Objekts
+        bool is_hot = false;
+        //wird beim Zusammenführen aller Dateien aufgelöst
+        ValueType value_type;
+        //Position im Objekt in Bytes, ab dem Anfang des Objekts einschließlich Header. Gesetzt von Driver::LayoutEngine
+        uint32_t layout_offset = 0;
+    };
+
+    struct TypeInfo {
+        std::string name;
+        std::string super_type;
+        size_t field_count = 0;
+        FieldInfo* fields = nullptr;
+        //Position der Deklaration: Index der Quelldatei (erst nach dem Zusammenführen gesetzt) und Offset des Namens
+        uint32_t file = 0;
+        uint32_t offset = 0;
+        uint32_t symbol = NO_SYMBOL;
+        //Scope mit Feldern und Member Functions
+        uint32_t member_scope = NO_SYMBOL;
+        //Index des Supertyps in types oder -1
+        int super_type_index = -1;
+        //Speicherlayout eines Objekts in Bytes, gesetzt von Driver::LayoutEngine. data_size ist das Ende des letzten Felds,
+        //declared_size die Größe bei Feldern in Deklarationsreihenfolge
+        uint32_t size = 0;
+        uint32_t alignment = 0;
+        uint32_t data_size = 0;
+        uint32_t padding = 0;
+        uint32_t declared_size = 0;
+        //dichte ID in Pre-Order über den Vererbungswald, gesetzt von Driver::ClassHierarchy. Die IDs aller Subtypen liegen
+        //im Intervall [type_id, last_subtype_id]
+        uint32_t type_id = 0;
+        uint32_t last_subtype_id = 0;
+    };
+
+    //zwei Vergleiche, unabhängig von der Tiefe der Hierarchie
+    inline bool is_subtype(const TypeInfo& type, const TypeInfo& super_type) {
+        return super_type.type_id <= type.type_id && type.type_id <= super_type.last_subtype_id;
+    }
+
+    //Syntaxbaum der Funktionsrümpfe. Die Knoten liegen in einer Arena und werden nie einzeln freigegeben
+    enum class ExprKind : uint8_t {
+        NUMBER_LITERAL,
+        STRING_LITERAL,
+        BOOL_LITERAL,
+        //lokale Variable oder Parameter, index ist der Slot
+        LOCAL,
+        //index ist der Index in global_vars
+        GLOBAL,
+        THIS,
+        //left ist das Objekt, owner der deklarierende Typ, index der Index des Felds in dessen fields
+        FIELD,
+        //index ist der Index in functions
+        CALL,
+        //left ist das Objekt, index die statisch gefundene Member Function
+        METHOD_CALL,
+        //wie METHOD_CALL, aber die Klassenhierarchie beweist, dass index das einzige mögliche Ziel ist
+        DIRECT_METHOD_CALL,
+        //index ist der Index des Typs
+        NEW,
+        //left ist das Objekt, index der Index des geprüften Typs
+        IS_TYPE,
+        UNARY,
+        BINARY
+    };
+
+    struct Expr {
+        ExprKind kind;
+        //Operator bei UNARY und BINARY
+        TokenType op = TokenType::PLACEHOLDER;
+        ValueType type;
+        //payload des Literal Tokens, bei NUMBER_LITERAL stattdessen der Wert, damit gefaltete Ergebnisse nicht auf float gerundet werden
+        union {
+            uint32_t payload = 0;
+            double number;
+        };
+        int index = -1;
+        int owner = -1;
+        Expr* left = nullptr;
+        Expr* right = nullptr;
+        Expr** args = nullptr;
+        uint32_t arg_count = 0;
+        //Offset im Quelltext für Fehlermeldungen
+        uint32_t offset = 0;
+    };
+
+    enum class StmtKind : uint8_t {
+        BLOCK,
+        EXPR,
+        VAR_DECL,
+        ASSIGN,
+        RETURN,
+        IF,
+        WHILE
+    };
+
+    struct Stmt {
+        StmtKind kind;
+        //Ziel einer Zuweisung (LOCAL, GLOBAL oder FIELD)
+        Expr* target = nullptr;
+        //Ausdruck, Initialisierung, zugewiesener Wert, Rückgabewert oder Bedingung, je nach kind
+        Expr* value = nullptr;
+        Stmt* body = nullptr;
+        Stmt* otherwise = nullptr;
+        Stmt** statements = nullptr;
+        uint32_t statement_count = 0;
+        //Slot der deklarierten Variable
+        int slot = -1;
+        uint32_t offset = 0;
+    };
+
+    struct FunctionBody {
+        Stmt* block = nullptr;
+        //Slots für this (bei Member Functions), Parameter und lokale Variablen, in dieser Reihenfolge
+        uint32_t local_count = 0;
+        ValueType* local_types = nullptr;
+    };
+
+    struct FunctionInfo {
+        std::string name;
+        std::string return_type;
+        size_t param_count = 0;
+        std::string* param_types = nullptr;
+        std::string* param_names = nullptr;
+        uint32_t file = 0;
+        uint32_t offset = 0;
+        //die Tokens des Rumpfs ohne die äußeren geschweiften Klammern. Geparst wird er erst in der zweiten Phase
+        std::vector<Token> code;
+        uint32_t symbol = NO_SYMBOL;
+        //Index des Typs bei Member Functions, sonst -1
+        int owner_type = -1;
+        bool is_linked = false;
+        bool is_intrinsic = false;
+        //werden beim Zusammenführen aller Dateien aufgelöst
+        ValueType return_value_type;
+        ValueType* param_value_types = nullptr;
+        //nullptr, solange der Rumpf noch nicht geparst wurde
+        FunctionBody* body = nullptr;
+    };
+
+    struct GlobalVarInfo {
+        std::string type;
+        std::string name;
+        uint32_t file = 0;
+        uint32_t offset = 0;
+        uint32_t symbol = NO_SYMBOL;
+        //Tokens des Initialisierungsausdrucks, leer wenn es keinen gibt
+        std::vector<Token> initializer;
+        ValueType value_type;
+        Expr* initializer_expr = nullptr;
+        //auch nach einem Fehler gesetzt, damit der Initialisierer nicht ein zweites Mal geparst und gemeldet wird
+        bool initializer_parsed = false;
+        //wird nirgends zugewiesen, gesetzt von Driver::ConstantFolder
+        bool is_constant = false;
+    };
+
+    struct ParseInfo {
+        size_t type_count;
+        TypeInfo* types;
+        size_t function_count;
+        FunctionInfo* functions;
+        size_t global_var_count;
+        GlobalVarInfo* global_vars;
+        //alle deklarierten Namen, die symbol Felder oben verweisen hier hinein
+        SymbolTable* symbols = nullptr;
+    };
+
+    inline bool is_builtin_type_name(const std::string& name) {
+        return name == "number" || name == "string" || name == "bool" || name == "numbers";
+    }
+
+    //gibt ein ParseInfo frei, das nie in ein Programm übernommen wurde, z.B. eine Deklaration im Server
+    void release_parse_info(ParseInfo& info) {
+        for (size_t i = 0; i < info.type_count; ++i)
+            delete[] info.types[i].fields;
+        for (size_t i = 0; i < info.function_count; ++i) {
+            delete[] info.functions[i].param_types;
+            delete[] info.functions[i].param_names;
+            delete[] info.functions[i].param_value_types;
+        }
+        delete[] info.types;
+        delete[] info.functions;
+        delete[] info.global_vars;
+        delete info.symbols;
+        info = ParseInfo{0, nullptr, 0, nullptr, 0, nullptr, nullptr};
+    }
+
+    void print_parse_info(ParseInfo info) {
+        Util::log(Util::SUMMARY, "Parse Info:\n");
+        Util::log(Util::SUMMARY, "=============\n");
+        Util::log(Util::SUMMARY, "Types:\n");
+        for (int i = 0; i < info.type_count; ++i) {
+            TypeInfo type_info = info.types[i];
+            Util::log(Util::SUMMARY, "type #%d: ",i);
+            Util::log(Util::SUMMARY, "%s", type_info.name.c_str());
+            Util::log(Util::SUMMARY, ", super-type: ");
+            Util::log(Util::SUMMARY, "%s", type_info.super_type.c_str());
+            Util::log(Util::SUMMARY, "\n");
+            for (int j = 0; j < type_info.field_count; j++) {
+                Util::log(Util::SUMMARY, "   %s %s\n", type_info.fields[j].name.c_str(), type_info.fields[j].type.c_str());
+            }
+        }
+        if (info.function_count > 0)
+            Util::log(Util::SUMMARY, "Functions:\n");
+        for (size_t i = 0; i < info.function_count; ++i) {
+            FunctionInfo& function_info = info.functions[i];
+            Util::log(Util::SUMMARY, "function #%zu: ", i);
+            if (function_info.is_linked)
+                Util::log(Util::SUMMARY, "linked ");
+            if (function_info.is_intrinsic)
+                Util::log(Util::SUMMARY, "intrinsic ");
+            if (function_info.owner_type != -1)
+                Util::log(Util::SUMMARY, "%s.", info.types[function_info.owner_type].name.c_str());
+            Util::log(Util::SUMMARY, "%s(", function_info.name.c_str());
+            for (size_t j = 0; j < function_info.param_count; ++j)
+                Util::log(Util::SUMMARY, j == 0 ? "%s %s" : ", %s %s", function_info.param_types[j].c_str(), function_info.param_names[j].c_str());
+            Util::log(Util::SUMMARY, ") -> %s, %zu tokens%s\n", function_info.return_type.empty() ? "void" : function_info.return_type.c_str(), function_info.code.size(), function_info.body != nullptr ? ", checked" : "");
+        }
+        if (info.global_var_count > 0)
+            Util::log(Util::SUMMARY, "Globals:\n");
+        for (size_t i = 0; i < info.global_var_count; ++i) {
+            Util::log(Util::SUMMARY, "global #%zu: %s %s%s\n", i, info.global_vars[i].type.c_str(), info.global_vars[i].name.c_str(), info.global_vars[i].initializer.empty() ? "" : " (initialized)");
+        }
+    }
+
+    //wird von Parser und BodyParser nach dem Melden eines Syntaxfehlers geworfen und an der nächsten Grenze (; oder }) gefangen.
+    //Verlässt nie den jeweiligen Parser
+    struct SyntaxError {
+    };
+
+    class Parser final {
+    public:
+        //der Parser zieht die Tokens bei Bedarf aus source, es wird nie mehr als die Lookahead Puffergröße gehalten.
+        //Mit defer_unresolved werden unbekannte Typnamen akzeptiert, da sie in einer anderen Datei stehen können.
+        //Sie werden dann erst beim Zusammenführen aller Dateien geprüft
+        Parser(TokenSource& source, const Util::StringInterner& interner, Diagnostics::DiagnosticList& diagnostics, bool defer_unresolved = false)
+            : source(source), interner(interner), diagnostics(diagnostics) {
+            this->defer_unresolved = defer_unresolved;
+        }
+
+        //nach einem Syntaxfehler wird bis zum Ende der Deklaration übersprungen und weitergeparst, bis das Fehlerlimit erreicht ist
+        ParseInfo parse() {
+            while (!is_eof() && !diagnostics.at_limit()) {
+                try {
+                    const Token& current_token = current();
+                    if (current_token.type == TokenType::DECL_FUNCTION || current_token.type == TokenType::LINKED || current_token.type == TokenType::INTRINSIC) {
+                        parse_function();
+                    } else if (current_token.type == TokenType::TYPE) {
+                        parse_type();
+                    } else {
+                        parse_global_var();
+                    }
+                } catch (const SyntaxError&) {
+                    synchronize();
+                    //eine übrig gebliebene schließende Klammer gehört zu der abgebrochenen Deklaration
+                    if (!is_eof() && current().type == TokenType::CLOSE_CURLY)
+                        consume();
+                }
+            }
+            if (!is_eof())
+                diagnostics.stop_at_limit();
+
+            //Ergebnisse in ein ParseInfo Object kopieren und dann zurückgeben
+            ParseInfo parse_result;
+            //Type Info kopieren
+            parse_result.type_count = types.size();
+            parse_result.types = new TypeInfo[types.size()];
+            for (int i = 0; i < types.size(); ++i)
+                parse_result.types[i] = types[i];
+            //Function Info kopieren
+            parse_result.function_count = functions.size();
+            parse_result.functions = new FunctionInfo[functions.size()];
+            for (int i = 0; i < functions.size(); ++i)
+                parse_result.functions[i] = functions[i];
+            //Global Var Info kopieren
+            parse_result.global_var_count = global_vars.size();
+            parse_result.global_vars = new GlobalVarInfo[global_vars.size()];
+            for (int i = 0; i < global_vars.size(); ++i)
+                parse_result.global_vars[i] = global_vars[i];
+            parse_result.symbols = symbols;
+            return parse_result;
+        }
+
+    private:
+        //Ringpuffer für current() und ahead()
+        static constexpr size_t LOOKAHEAD_SIZE = 8;
+        TokenSource& source;
+        Token lookahead[LOOKAHEAD_SIZE];
+        size_t lookahead_start = 0, lookahead_count = 0;
+        bool source_exhausted = false;
+        //löst die Namens-IDs der Tokens auf
+        const Util::StringInterner& interner;
+        Diagnostics::DiagnosticList& diagnostics;
+        //Offset des zuletzt entnommenen Tokens, für Fehler am Dateiende
+        uint32_t last_offset = 0;
+        bool reported_eof = false;
+        bool defer_unresolved = false;
+        //Namen werden über ihre ID im Interner nachgeschlagen
+        SymbolTable* symbols = new SymbolTable();
+        //zur Zwischenspeicherung der Ergebnisse
+        std::vector<TypeInfo> types;
+        std::vector<FunctionInfo> functions;
+        std::vector<GlobalVarInfo> global_vars;
+
+        //stellt sicher, dass mindestens count Tokens im Ringpuffer liegen, soweit die Quelle noch welche hat
+        bool fill(size_t count) {
+            while (lookahead_count < count && !source_exhausted) {
+                Token& slot = lookahead[(lookahead_start + lookahead_count) % LOOKAHEAD_SIZE];
+                if (source.next(slot))
+                    ++lookahead_count;
+                else
+                    source_exhausted = true;
+            }
+            return lookahead_count >= count;
+        }
+
+        Token consume() {
+            if (is_eof()) {
+                if (!reported_eof)
+                    diagnostics.error(last_offset, "Unexpectedly ran into end of file while parsing");
+                reported_eof = true;
+                throw SyntaxError();
+            }
+            Token token = lookahead[lookahead_start];
+            lookahead_start = (lookahead_start + 1) % LOOKAHEAD_SIZE;
+            --lookahead_count;
+            last_offset = token.offset;
+            return token;
+        }
+
+        [[noreturn]] void syntax_error(const Token& token, const char* message) {
+            diagnostics.error(token.offset, message);
+            throw SyntaxError();
+        }
+
+        //überspringt bis hinter das nächste ; oder den nächsten vollständigen { } Block auf der aktuellen Ebene. Eine schließende
+        //Klammer der umgebenden Ebene bleibt stehen
+        void synchronize() {
+            size_t depth = 0;
+            while (!is_eof()) {
+                TokenType type = current().type;
+                if (type == TokenType::CLOSE_CURLY && depth == 0)
+                    return;
+                consume();
+                if (type == TokenType::SEMICOLON && depth == 0)
+                    return;
+                if (type == TokenType::OPEN_CURLY) {
+                    ++depth;
+                } else if (type == TokenType::CLOSE_CURLY && --depth == 0) {
+                    return;
+                }
+            }
+        }
+
+        const Token& current() {
+            fill(1);
+            return lookahead[lookahead_start];
+        }
+
+        const Token& ahead(int skips = 0) {
+            size_t needed = 2 + skips;
+            if (needed > LOOKAHEAD_SIZE)
+                Util::error("Parser lookahead exceeds the token buffer");
+            fill(needed);
+            //wie bisher: hinter dem Ende wird das letzte Token geliefert
+            size_t index = needed <= lookahead_count ? needed - 1 : lookahead_count - 1;
+            return lookahead[(lookahead_start + index) % LOOKAHEAD_SIZE];
+        }
+
+        bool is_eof() {
+            return !fill(1);
+        }
+
+        bool identifier_exists(uint32_t identifier) {
+            return symbols->lookup(identifier) != NO_SYMBOL;
+        }
+
+        //liefert den Index des Typs in types oder -1
+        int find_type(uint32_t name) {
+            uint32_t symbol = symbols->lookup(name);
+            if (symbol == NO_SYMBOL || symbols->get(symbol).kind != SymbolKind::TYPE)
+                return -1;
+            return static_cast<int>(symbols->get(symbol).index);
+        }
+
+        bool type_exists(uint32_t name) {
+            return find_type(name) != -1;
+        }
+
+        //sucht ein Member (Feld oder Member Function) im Typ und allen Supertypen
+        uint32_t find_member(int type_index, uint32_t name) {
+            while (type_index != -1) {
+                uint32_t symbol = symbols->lookup_in_scope(types[type_index].member_scope, name);
+                if (symbol != NO_SYMBOL)
+                    return symbol;
+                type_index = types[type_index].super_type_index;
+            }
+            return NO_SYMBOL;
+        }
+
+        void parse_type() {
+            TypeInfo type_info;
+            //"type" keyword entfernen
+            consume();
+            //zuerst werden Name und Name der Superklasse entnommen
+            Token name_token = consume();
+            if (name_token.type != TokenType::NAME) {
+                syntax_error(name_token, "Expected name after type declaration");
+            }
+            uint32_t type_id = name_token.payload;
+            std::string type_name(get_str_value(interner, name_token));
+            int type_index = static_cast<int>(types.size());
+            type_info.offset = name_token.offset;
+            type_info.symbol = symbols->declare(type_id, SymbolKind::TYPE, type_index);
+            //ein doppelter Typ wird trotzdem geparst, um Fehler darin zu finden, am Ende aber verworfen
+            bool discard = type_info.symbol == NO_SYMBOL;
+            if (discard)
+                diagnostics.error(name_token.offset, "Identifier is already taken: " + type_name);
+            size_t function_count_before = functions.size();
+            type_info.name = type_name;
+            type_info.member_scope = symbols->create_scope(ScopeKind::TYPE_MEMBER, SymbolTable::GLOBAL_SCOPE);
+            Token next_token = consume();
+            if (next_token.type == TokenType::FROM) {
+                name_token = consume();
+                if (name_token.type != TokenType::NAME) {
+                    syntax_error(name_token, "Expected name after from clause");
+                }
+                type_name = get_str_value(interner, name_token);
+                type_info.super_type_index = find_type(name_token.payload);
+                if (type_info.super_type_index == -1 && !defer_unresolved) {
+                    diagnostics.error(name_token.offset, "type in from clause does not exist");
+                }
+                type_info.super_type = type_name;
+                next_token = consume();
+            }
+            if (next_token.type != TokenType::OPEN_CURLY) {
+                syntax_error(next_token, "Expected open curly brace after type declaration");
+            }
+            //der Typ wird schon jetzt eingetragen, damit Felder und Member Functions ihn über find_member erreichen
+            types.push_back(type_info);
+
+            //nun werden Attribute und Methoden entnommen
+            std::vector<FieldInfo> fields;
+            next_token = consume();
+            while(next_token.type != TokenType::CLOSE_CURLY) {
+                //ein fehlerhaftes Member wird bis zum ; übersprungen, der Rest des Typs wird weiter geparst
+                try {
+                    if (next_token.type == TokenType::DECL_FUNCTION) {
+                        //das Entnehmen von Member Functions wird in eine eigene Methode ausgelagert, da die Member Functions nicht Teil des Datentyps sind, sondern nur einen versteckten Parameter haben
+                        parse_member_function(type_index, next_token);
+                    } else {
+                        parse_field(type_info, type_id, next_token, fields);
+                    }
+                } catch (const SyntaxError&) {
+                    if (diagnostics.at_limit())
+                        throw;
+                    synchronize();
+                }
+                next_token = consume();
+            }
+            if (discard) {
+                types.pop_back();
+                functions.resize(function_count_before);
+                return;
+            }
+            TypeInfo& stored_type = types[type_index];
+            stored_type.field_count = fields.size();
+            stored_type.fields = new FieldInfo[fields.size()];
+            for (size_t i = 0; i < fields.size(); ++i)
+                stored_type.fields[i] = fields[i];
+        }
+
+        //[hot] typ name; innerhalb eines Typs, das erste Token wurde schon entnommen. hot ist nur hier ein Schlüsselwort,
+        //"hot name;" ist weiterhin ein Feld vom Typ hot
+        void parse_field(const TypeInfo& type_info, uint32_t type_id, Token type_token, std::vector<FieldInfo>& fields) {
+            FieldInfo field_info;
+            if (type_token.type == TokenType::NAME && ahead().type == TokenType::NAME && get_str_value(interner, type_token) == "hot") {
+                TokenType next_type = current().type;
+                if (next_type == TokenType::NAME || next_type == TokenType::NUM || next_type == TokenType::STR || next_type == TokenType::BOOL || next_type == TokenType::NUMBERS) {
+                    field_info.is_hot = true;
+                    type_token = consume();
+                }
+            }
+            if (type_token.type == TokenType::NAME) {
+                std::string type_name(get_str_value(interner, type_token));
+                if (type_token.payload != type_id && !type_exists(type_token.payload) && !defer_unresolved)
+                    diagnostics.error(type_token.offset, "Unknown type: " + type_name);
+                field_info.type = type_name;
+            } else if (type_token.type == TokenType::NUM) {
+                field_info.type = "number";
+            } else if (type_token.type == TokenType::STR) {
+                field_info.type = "string";
+            } else if (type_token.type == TokenType::BOOL) {
+                field_info.type = "bool";
+            } else if (type_token.type == TokenType::NUMBERS) {
+                field_info.type = "numbers";
+            } else {
+                syntax_error(type_token, "Expected type identifier at beginning of field declaration");
+            }
+            Token name_token = consume();
+            if (name_token.type != TokenType::NAME) {
+                syntax_error(name_token, "Expected identifier after field declaration");
+            }
+            std::string field_name(get_str_value(interner, name_token));
+            Util::log(Util::TRACE, "got field name %s\n", field_name.c_str());
+            field_info.name = field_name;
+            field_info.offset = name_token.offset;
+            Token next_token = consume();
+            if (next_token.type != TokenType::SEMICOLON)
+                syntax_error(next_token, "Expected semicolon after field declaration");
+            //doppelte Felder werden gemeldet und verworfen
+            field_info.symbol = symbols->declare_in_scope(type_info.member_scope, name_token.payload, SymbolKind::FIELD, static_cast<uint32_t>(fields.size()));
+            if (field_info.symbol == NO_SYMBOL) {
+                diagnostics.error(name_token.offset, "Duplicate identifier: " + field_name);
+                return;
+            }
+            fields.push_back(field_info);
+        }
+
+        //liest einen Typnamen (number, string, bool, numbers oder den Namen eines Typs), liefert false, wenn token keiner ist
+        bool parse_type_name(const Token& token, std::string& type_name) {
+            if (token.type == TokenType::NUM) {
+                type_name = "number";
+            } else if (token.type == TokenType::STR) {
+                type_name = "string";
+            } else if (token.type == TokenType::BOOL) {
+                type_name = "bool";
+            } else if (token.type == TokenType::NUMBERS) {
+                type_name = "numbers";
+            } else if (token.type == TokenType::NAME) {
+                type_name = get_str_value(interner, token);
+                if (!type_exists(token.payload) && !defer_unresolved)
+                    diagnostics.error(token.offset, "Unknown type: " + type_name);
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        //übernimmt alle Tokens bis zur passenden schließenden Klammer. Die öffnende Klammer wurde schon entnommen,
+        //die schließende landet nicht in tokens
+        void collect_block(std::vector<Token>& tokens) {
+            size_t depth = 1;
+            while (true) {
+                Token token = consume();
+                if (token.type == TokenType::OPEN_CURLY) {
+                    ++depth;
+                } else if (token.type == TokenType::CLOSE_CURLY) {
+                    if (--depth == 0)
+                        return;
+                }
+                tokens.push_back(token);
+            }
+        }
+
+        //[linked|intrinsic] function<typ> name(typ name, ...) { ... }
+        //In der ersten Phase wird nur die Signatur ausgewertet, der Rumpf wird als Token Liste für die zweite Phase gespeichert.
+        //linked und intrinsic Funktionen haben statt eines Rumpfs ein Semikolon
+        void parse_function_declaration(int owner_type, Token next_token) {
+            FunctionInfo function_info;
+            function_info.owner_type = owner_type;
+            if (next_token.type == TokenType::LINKED || next_token.type == TokenType::INTRINSIC) {
+                if (owner_type != -1)
+                    diagnostics.error(next_token.offset, "Member functions can not be linked or intrinsic");
+                function_info.is_linked = next_token.type == TokenType::LINKED;
+                function_info.is_intrinsic = next_token.type == TokenType::INTRINSIC;
+                next_token = consume();
+            }
+            if (next_token.type != TokenType::DECL_FUNCTION) {
+                syntax_error(next_token, "Expected function declaration");
+            }
+            function_info.return_type = get_str_value(interner, next_token);
+            if (!defer_unresolved && !function_info.return_type.empty() && !is_builtin_type_name(function_info.return_type) && !type_exists(next_token.payload))
+                diagnostics.error(next_token.offset, "Unknown type: " + function_info.return_type);
+            Token name_token = consume();
+            if (name_token.type != TokenType::NAME) {
+                syntax_error(name_token, "Expected name after function declaration");
+            }
+            function_info.name = get_str_value(interner, name_token);
+            function_info.offset = name_token.offset;
+            next_token = consume();
+            if (next_token.type != TokenType::OPEN_PARA) {
+                syntax_error(next_token, "Expected open parenthesis after function name");
+            }
+
+            std::vector<std::string> param_types;
+            std::vector<std::string> param_names;
+            std::vector<uint32_t> param_ids;
+            next_token = consume();
+            while (next_token.type != TokenType::CLOSE_PARA) {
+                std::string type_name;
+                if (!parse_type_name(next_token, type_name)) {
+                    syntax_error(next_token, "Expected type identifier at beginning of parameter declaration");
+                }
+                Token param_token = consume();
+                if (param_token.type != TokenType::NAME) {
+                    syntax_error(param_token, "Expected identifier after parameter type");
+                }
+                for (size_t i = 0; i < param_ids.size(); ++i) {
+                    if (param_ids[i] == param_token.payload)
+                        diagnostics.error(param_token.offset, "Duplicate identifier: " + std::string(get_str_value(interner, param_token)));
+                }
+                param_types.push_back(type_name);
+                param_names.push_back(std::string(get_str_value(interner, param_token)));
+                param_ids.push_back(param_token.payload);
+                next_token = consume();
+                if (next_token.type == TokenType::COMMA) {
+                    next_token = consume();
+                } else if (next_token.type != TokenType::CLOSE_PARA) {
+                    syntax_error(next_token, "Expected comma or closing parenthesis in parameter list");
+                }
+            }
+            function_info.param_count = param_types.size();
+            function_info.param_types = new std::string[param_types.size()];
+            function_info.param_names = new std::string[param_names.size()];
+            for (size_t i = 0; i < param_types.size(); ++i) {
+                function_info.param_types[i] = param_types[i];
+                function_info.param_names[i] = param_names[i];
+            }
+
+            next_token = consume();
+            if (function_info.is_linked || function_info.is_intrinsic) {
+                if (next_token.type != TokenType::SEMICOLON)
+                    syntax_error(next_token, "Expected semicolon after linked or intrinsic function declaration");
+            } else {
+                if (next_token.type != TokenType::OPEN_CURLY)
+                    syntax_error(next_token, "Expected open curly brace after function signature");
+                collect_block(function_info.code);
+            }
+
+            uint32_t function_index = static_cast<uint32_t>(functions.size());
+            if (owner_type == -1)
+                function_info.symbol = symbols->declare_in_scope(SymbolTable::GLOBAL_SCOPE, name_token.payload, SymbolKind::FUNCTION, function_index);
+            else
+                function_info.symbol = symbols->declare_in_scope(types[owner_type].member_scope, name_token.payload, SymbolKind::MEMBER_FUNCTION, function_index);
+            if (function_info.symbol == NO_SYMBOL) {
+                diagnostics.error(name_token.offset, "Identifier is already taken: " + function_info.name);
+                return;
+            }
+            functions.push_back(std::move(function_info));
+        }
+
+        void parse_member_function(int type_index, Token declaration_token) {
+            parse_function_declaration(type_index, declaration_token);
+        }
+
+        void parse_function() {
+            parse_function_declaration(-1, consume());
+        }
+
+        //typ name; oder typ name = ausdruck;
+        //der Initialisierungsausdruck wird wie ein Funktionsrumpf erst in der zweiten Phase geparst
+        void parse_global_var() {
+            GlobalVarInfo global_info;
+            Token type_token = consume();
+            if (!parse_type_name(type_token, global_info.type)) {
+                syntax_error(type_token, "Expected type, function or global variable declaration");
+            }
+            Token name_token = consume();
+            if (name_token.type != TokenType::NAME) {
+                syntax_error(name_token, "Expected identifier after global variable type");
+            }
+            global_info.name = get_str_value(interner, name_token);
+            global_info.offset = name_token.offset;
+            Token next_token = consume();
+            if (next_token.type == TokenType::EQUALS) {
+                size_t depth = 0;
+                next_token = consume();
+                while (depth > 0 || next_token.type != TokenType::SEMICOLON) {
+                    //ohne ; würde sonst der Rest der Datei zum Ausdruck
+                    if (depth == 0 && (next_token.type == TokenType::CLOSE_CURLY || next_token.type == TokenType::TYPE || next_token.type == TokenType::DECL_FUNCTION))
+                        syntax_error(next_token, "Expected semicolon after global variable declaration");
+                    if (next_token.type == TokenType::OPEN_PARA || next_token.type == TokenType::OPEN_CURLY)
+                        ++depth;
+                    else if ((next_token.type == TokenType::CLOSE_PARA || next_token.type == TokenType::CLOSE_CURLY) && depth > 0)
+                        --depth;
+                    global_info.initializer.push_back(next_token);
+                    next_token = consume();
+                }
+                if (global_info.initializer.empty())
+                    syntax_error(next_token, "Expected expression after equals in global variable declaration");
+            } else if (next_token.type != TokenType::SEMICOLON) {
+                syntax_error(next_token, "Expected semicolon after global variable declaration");
+            }
+            global_info.symbol = symbols->declare_in_scope(SymbolTable::GLOBAL_SCOPE, name_token.payload, SymbolKind::GLOBAL_VAR, static_cast<uint32_t>(global_vars.size()));
+            if (global_info.symbol == NO_SYMBOL) {
+                diagnostics.error(name_token.offset, "Identifier is already taken: " + global_info.name);
+                return;
+            }
+            global_vars.push_back(std::move(global_info));
+        }
+
+
+    };
+
+
+    //zweite Phase: parst einen Funktionsrumpf oder Initialisierungsausdruck und prüft dabei Namen und Typen.
+    //info und interner werden nur gelesen, es können also mehrere BodyParser parallel laufen, solange jeder seine eigene Arena
+    //und Fehlerliste hat. Syntaxfehler brechen die aktuelle Anweisung ab, Typfehler werden nur gemeldet
+    class BodyParser final {
+    public:
+        BodyParser(const ParseInfo& info, const Util::StringInterner& interner, Util::Arena& arena, Diagnostics::DiagnosticList& diagnostics)
+            : info(info), interner(interner), arena(arena), diagnostics(diagnostics), is_name(interner.find("is")) {
+        }
+
+        FunctionBody* parse_function_body(const FunctionInfo& function_info) {
+            start(function_info.code, function_info.file, function_info.offset);
+            this->function_info = &function_info;
+            this_type = function_info.owner_type;
+            locals.enter_scope(ScopeKind::FUNCTION);
+            if (this_type != -1)
+                local_types.push_back(make_type(ValueType::OBJECT, this_type));
+            for (size_t i = 0; i < function_info.param_count; ++i) {
+                //ein Name, der nie im Programm vorkommt, kann auch nie benutzt werden
+                uint32_t name = interner.find(function_info.param_names[i]);
+                if (name != UINT32_MAX)
+                    locals.declare(name, SymbolKind::PARAMETER, static_cast<uint32_t>(local_types.size()));
+                local_types.push_back(function_info.param_value_types[i]);
+            }
+            FunctionBody* body = arena.create<FunctionBody>();
+            try {
+                body->block = parse_block_contents(false);
+            } catch (const SyntaxError&) {
+                //nur bei erreichtem Fehlerlimit
+                body->block = make_stmt(StmtKind::BLOCK);
+                diagnostics.stop_at_limit();
+            }
+            body->local_count = static_cast<uint32_t>(local_types.size());
+            body->local_types = copy_array(local_types);
+            return body;
+        }
+
+        //liefert nullptr, wenn der Ausdruck fehlerhaft ist
+        Expr* parse_initializer(const GlobalVarInfo& global_info) {
+            start(global_info.initializer, global_info.file, global_info.offset);
+            try {
+                Expr* value = parse_expression();
+                if (!at_end())
+                    fail("Unexpected token after initializer expression");
+                check_assignable(global_info.value_type, value, "Initializer does not match the type of the global variable");
+                return value;
+            } catch (const SyntaxError&) {
+                return nullptr;
+            }
+        }
+
+    private:
+        const ParseInfo& info;
+        const Util::StringInterner& interner;
+        Util::Arena& arena;
+        Diagnostics::DiagnosticList& diagnostics;
+        //is ist nur vor einem Typnamen ein Operator, sonst ein gewöhnlicher Name
+        uint32_t is_name;
+        const std::vector<Token>* tokens = nullptr;
+        size_t pointer = 0;
+        //Position der Deklaration, für Fehler in leeren Rümpfen
+        uint32_t declaration_offset = 0;
+        const FunctionInfo* function_info = nullptr;
+        int this_type = -1;
+        SymbolTable locals;
+        std::vector<ValueType> local_types;
+
+        void start(const std::vector<Token>& tokens, uint32_t file, uint32_t offset) {
+            this->tokens = &tokens;
+            pointer = 0;
+            declaration_offset = offset;
+            diagnostics.set_file(file);
+            function_info = nullptr;
+            this_type = -1;
+            locals = SymbolTable();
+            local_types.clear();
+        }
+
+        //Offset des aktuellen Tokens, am Ende der des letzten
+        uint32_t location() {
+            if (!at_end())
+                return (*tokens)[pointer].offset;
+            return tokens->empty() ? declaration_offset : tokens->back().offset;
+        }
+
+        [[noreturn]] void fail(const char* message) {
+            diagnostics.error(location(), message);
+            throw SyntaxError();
+        }
+
+        void report(uint32_t offset, const char* message) {
+            diagnostics.error(offset, message);
+        }
+
+        template<typename T>
+        T* copy_array(const std::vector<T>& items) {
+            if (items.empty())
+                return nullptr;
+            T* copy = static_cast<T*>(arena.allocate(sizeof(T) * items.size(), alignof(T)));
+            for (size_t i = 0; i < items.size(); ++i)
+                new (&copy[i]) T(items[i]);
+            return copy;
+        }
+
+        bool at_end() {
+            return pointer >= tokens->size();
+        }
+
+        TokenType current_type() {
+            return at_end() ? TokenType::TOKEN_TYPE_COUNT : (*tokens)[pointer].type;
+        }
+
+        TokenType ahead_type(size_t skips = 0) {
+            size_t index = pointer + 1 + skips;
+            return index >= tokens->size() ? TokenType::TOKEN_TYPE_COUNT : (*tokens)[index].type;
+        }
+
+        Token consume() {
+            if (at_end())
+                fail("Unexpectedly reached the end of the function body");
+            return (*tokens)[pointer++];
+        }
+
+        Token expect(TokenType type, const char* message) {
+            if (current_type() != type)
+                fail(message);
+            return consume();
+        }
+
+        //überspringt bis hinter das nächste ; oder den nächsten vollständigen { } Block. Eine schließende Klammer des
+        //umgebenden Blocks bleibt stehen
+        void synchronize() {
+            size_t depth = 0;
+            while (!at_end()) {
+                TokenType type = current_type();
+                if (type == TokenType::CLOSE_CURLY && depth == 0)
+                    return;
+                ++pointer;
+                if (type == TokenType::SEMICOLON && depth == 0)
+                    return;
+                if (type == TokenType::OPEN_CURLY) {
+                    ++depth;
+                } else if (type == TokenType::CLOSE_CURLY && --depth == 0) {
+                    return;
+                }
+            }
+        }
+
+        //Typen
+
+        static ValueType make_type(ValueType::Kind kind, int type_index = -1) {
+            ValueType value_type;
+            value_type.kind = kind;
+            value_type.type_index = type_index;
+            return value_type;
+        }
+
+        bool is_assignable(const ValueType& target, const ValueType& value) {
+            if (target.kind == ValueType::ERROR || value.kind == ValueType::ERROR)
+                return true;
+            if (target.kind != value.kind)
+                return false;
+            if (target.kind == ValueType::OBJECT)
+                return is_subtype(info.types[value.type_index], info.types[target.type_index]);
+            return true;
+        }
+
+        void check_assignable(const ValueType& target, const Expr* value, const char* message) {
+            if (!is_assignable(target, value->type))
+                report(value->offset, message);
+        }
+
+        //liest einen Typ am Anfang einer Variablendeklaration, liefert false, wenn dort keiner steht
+        bool parse_declared_type(ValueType& value_type) {
+            TokenType type = current_type();
+            if (type == TokenType::NUM) {
+                value_type = make_type(ValueType::NUMBER);
+            } else if (type == TokenType::STR) {
+                value_type = make_type(ValueType::STRING);
+            } else if (type == TokenType::BOOL) {
+                value_type = make_type(ValueType::BOOL);
+            } else if (type == TokenType::NUMBERS) {
+                value_type = make_type(ValueType::NUMBERS);
+            } else if (type == TokenType::NAME && ahead_type() == TokenType::NAME) {
+                int type_index = find_type((*tokens)[pointer].payload);
+                if (type_index == -1)
+                    fail("Unknown type in variable declaration");
+                value_type = make_type(ValueType::OBJECT, type_index);
+            } else {
+                return false;
+            }
             consume();
-            std::stringstream string_builder;
-            while(current() != '"') {
-                string_builder << consume();
-                if (is_eof()) {
-                    Util::error("Reached end of file while parsing string literal");
+            return true;
+        }
+
+        //Namensauflösung
+
+        int find_type(uint32_t name) {
+            uint32_t symbol = info.symbols->lookup_in_scope(SymbolTable::GLOBAL_SCOPE, name);
+            if (symbol == NO_SYMBOL || info.symbols->get(symbol).kind != SymbolKind::TYPE)
+                return -1;
+            return static_cast<int>(info.symbols->get(symbol).index);
+        }
+
+        //sucht ein Member im Typ und allen Supertypen. owner ist danach der Typ, der es deklariert
+        uint32_t find_member(int type_index, uint32_t name, int& owner) {
+            while (type_index != -1) {
+                uint32_t symbol = info.symbols->lookup_in_scope(info.types[type_index].member_scope, name);
+                if (symbol != NO_SYMBOL) {
+                    owner = type_index;
+                    return symbol;
+                }
+                type_index = info.types[type_index].super_type_index;
+            }
+            return NO_SYMBOL;
+        }
+
+        Expr* make_expr(ExprKind kind, ValueType type, uint32_t offset) {
+            Expr* expr = arena.create<Expr>();
+            expr->kind = kind;
+            expr->type = type;
+            expr->offset = offset;
+            return expr;
+        }
+
+        Expr* make_this(uint32_t offset) {
+            Expr* expr = make_expr(ExprKind::THIS, make_type(ValueType::OBJECT, this_type), offset);
+            expr->index = 0;
+            return expr;
+        }
+
+        Expr* make_field(Expr* object, int owner, uint32_t symbol, uint32_t offset) {
+            const FieldInfo& field_info = info.types[owner].fields[info.symbols->get(symbol).index];
+            Expr* expr = make_expr(ExprKind::FIELD, field_info.value_type, offset);
+            expr->left = object;
+            expr->owner = owner;
+            expr->index = static_cast<int>(info.symbols->get(symbol).index);
+            return expr;
+        }
+
+        //Argumentliste ab der öffnenden Klammer, geprüft gegen die Parameter von callee
+        void parse_arguments(Expr* call, const FunctionInfo& callee) {
+            expect(TokenType::OPEN_PARA, "Expected open parenthesis before arguments");
+            std::vector<Expr*> args;
+            if (current_type() != TokenType::CLOSE_PARA) {
+                while (true) {
+                    args.push_back(parse_expression());
+                    if (current_type() != TokenType::COMMA)
+                        break;
+                    consume();
+                }
+            }
+            expect(TokenType::CLOSE_PARA, "Expected closing parenthesis after arguments");
+            if (args.size() != callee.param_count) {
+                report(call->offset, "Wrong number of arguments in function call");
+            } else {
+                for (size_t i = 0; i < args.size(); ++i)
+                    check_assignable(callee.param_value_types[i], args[i], "Argument does not match the parameter type");
+            }
+            call->args = copy_array(args);
+            call->arg_count = static_cast<uint32_t>(args.size());
+        }
+
+        Expr* make_method_call(Expr* object, uint32_t symbol, uint32_t offset) {
+            const FunctionInfo& callee = info.functions[info.symbols->get(symbol).index];
+            Expr* call = make_expr(ExprKind::METHOD_CALL, callee.return_value_type, offset);
+            call->left = object;
+            call->index = static_cast<int>(info.symbols->get(symbol).index);
+            parse_arguments(call, callee);
+            return call;
+        }
+
+        //Ausdrücke, nach Bindungsstärke von schwach nach stark
+
+        static int binary_precedence(TokenType type) {
+            switch (type) {
+                case TokenType::OR_OR: return 1;
+                case TokenType::AND_AND: return 2;
+                case TokenType::EQUALS_EQUALS:
+                case TokenType::NOT_EQUALS: return 3;
+                case TokenType::LESS:
+                case TokenType::GREATER:
+                case TokenType::LESS_EQUALS:
+                case TokenType::GREATER_EQUALS: return 4;
+                case TokenType::PLUS:
+                case TokenType::MINUS: return 5;
+                case TokenType::STAR:
+                case TokenType::SLASH:
+                case TokenType::PERCENT: return 6;
+                default: return -1;
+            }
+        }
+
+        //objekt is Typ bindet wie die Vergleichsoperatoren
+        static constexpr int TYPE_TEST_PRECEDENCE = 4;
+
+        bool at_type_test() {
+            return current_type() == TokenType::NAME && (*tokens)[pointer].payload == is_name && ahead_type() == TokenType::NAME;
+        }
+
+        Expr* parse_expression(int min_precedence = 1) {
+            Expr* left = parse_unary();
+            while (true) {
+                bool type_test = at_type_test();
+                int precedence = type_test ? TYPE_TEST_PRECEDENCE : binary_precedence(current_type());
+                if (precedence < min_precedence)
+                    return left;
+                if (type_test) {
+                    left = parse_type_test(left);
+                    continue;
+                }
+                Token op = consume();
+                Expr* right = parse_expression(precedence + 1);
+                left = make_binary(op, left, right);
+            }
+        }
+
+        Expr* parse_type_test(Expr* object) {
+            Token is_token = consume();
+            Token type_token = consume();
+            int type_index = find_type(type_token.payload);
+            if (type_index == -1) {
+                report(type_token.offset, "Unknown type in type test");
+                return make_expr(ExprKind::BOOL_LITERAL, make_type(ValueType::ERROR), is_token.offset);
+            }
+            if (object->type.kind != ValueType::OBJECT) {
+                if (object->type.kind != ValueType::ERROR)
+                    report(is_token.offset, "Only objects can be tested against a type");
+                return make_expr(ExprKind::BOOL_LITERAL, make_type(ValueType::ERROR), is_token.offset);
+            }
+            const TypeInfo& static_type = info.types[object->type.type_index];
+            const TypeInfo& tested_type = info.types[type_index];
+            if (!is_subtype(static_type, tested_type) && !is_subtype(tested_type, static_type))
+                diagnostics.warning(is_token.offset, "Type test can never succeed: " + static_type.name + " is not related to " + tested_type.name);
+            Expr* expr = make_expr(ExprKind::IS_TYPE, make_type(ValueType::BOOL), is_token.offset);
+            expr->left = object;
+            expr->index = type_index;
+            return expr;
+        }
+
+        Expr* make_binary(const Token& op, Expr* left, Expr* right) {
+            ValueType::Kind kind = left->type.kind;
+            ValueType result;
+            //ein Operand mit unbekanntem Typ wurde schon gemeldet
+            bool has_error = kind == ValueType::ERROR || right->type.kind == ValueType::ERROR;
+            const char* message = nullptr;
+            switch (op.type) {
+                case TokenType::PLUS:
+                    if (kind != right->type.kind || (kind != ValueType::NUMBER && kind != ValueType::STRING))
+                        message = "Operator + expects two numbers or two strings";
+                    result = make_type(kind);
+                    break;
+                case TokenType::MINUS:
+                case TokenType::STAR:
+                case TokenType::SLASH:
+                case TokenType::PERCENT:
+                    if (kind != ValueType::NUMBER || right->type.kind != ValueType::NUMBER)
+                        message = "Arithmetic operators expect numbers";
+                    result = make_type(ValueType::NUMBER);
+                    break;
+                case TokenType::LESS:
+                case TokenType::GREATER:
+                case TokenType::LESS_EQUALS:
+                case TokenType::GREATER_EQUALS:
+                    if (kind != ValueType::NUMBER || right->type.kind != ValueType::NUMBER)
+                        message = "Comparison operators expect numbers";
+                    result = make_type(ValueType::BOOL);
+                    break;
+                case TokenType::EQUALS_EQUALS:
+                case TokenType::NOT_EQUALS:
+                    if (!is_assignable(left->type, right->type) && !is_assignable(right->type, left->type))
+                        message = "Equality operators expect operands of the same type";
+                    else if (kind == ValueType::VOID)
+                        message = "Can not compare values of functions without return type";
+                    result = make_type(ValueType::BOOL);
+                    break;
+                case TokenType::AND_AND:
+                case TokenType::OR_OR:
+                    if (kind != ValueType::BOOL || right->type.kind != ValueType::BOOL)
+                        message = "Logical operators expect booleans";
+                    result = make_type(ValueType::BOOL);
+                    break;
+                default:
+                    message = "Unknown binary operator";
+                    break;
+            }
+            if (has_error) {
+                result = make_type(ValueType::ERROR);
+            } else if (message != nullptr) {
+                report(op.offset, message);
+                result = make_type(ValueType::ERROR);
+            }
+            Expr* expr = make_expr(ExprKind::BINARY, result, op.offset);
+            expr->op = op.type;
+            expr->left = left;
+            expr->right = right;
+            return expr;
+        }
+
+        Expr* parse_unary() {
+            TokenType type = current_type();
+            if (type == TokenType::BANG || type == TokenType::MINUS) {
+                Token op = consume();
+                Expr* operand = parse_unary();
+                ValueType::Kind expected = type == TokenType::BANG ? ValueType::BOOL : ValueType::NUMBER;
+                ValueType result = operand->type;
+                if (operand->type.kind != expected && operand->type.kind != ValueType::ERROR) {
+                    report(op.offset, type == TokenType::BANG ? "Operator ! expects a boolean" : "Unary minus expects a number");
+                    result = make_type(ValueType::ERROR);
+                }
+                Expr* expr = make_expr(ExprKind::UNARY, result, op.offset);
+                expr->op = type;
+                expr->left = operand;
+                return expr;
+            }
+            return parse_postfix(parse_primary());
+        }
+
+        Expr* parse_postfix(Expr* expr) {
+            while (current_type() == TokenType::PERIOD) {
+                consume();
+                Token name_token = expect(TokenType::NAME, "Expected member name after period");
+                if (expr->type.kind != ValueType::OBJECT) {
+                    if (expr->type.kind != ValueType::ERROR)
+                        report(name_token.offset, "Only objects have members");
+                    throw_after_member_error();
+                }
+                int owner = -1;
+                uint32_t symbol = find_member(expr->type.type_index, name_token.payload, owner);
+                if (symbol == NO_SYMBOL) {
+                    diagnostics.error(name_token.offset, "Unknown member: " + std::string(get_str_value(interner, name_token)));
+                    throw_after_member_error();
+                }
+                if (info.symbols->get(symbol).kind == SymbolKind::MEMBER_FUNCTION)
+                    expr = make_method_call(expr, symbol, name_token.offset);
+                else
+                    expr = make_field(expr, owner, symbol, name_token.offset);
+            }
+            return expr;
+        }
+
+        //ohne bekanntes Member lässt sich der Rest der Anweisung nicht sinnvoll prüfen, der Fehler ist schon gemeldet
+        [[noreturn]] void throw_after_member_error() {
+            throw SyntaxError();
+        }
+
+        Expr* parse_primary() {
+            Token token = consume();
+            switch (token.type) {
+                case TokenType::NUM_LITERAL: {
+                    Expr* expr = make_expr(ExprKind::NUMBER_LITERAL, make_type(ValueType::NUMBER), token.offset);
+                    expr->number = get_number_value(interner, token);
+                    return expr;
+                }
+                case TokenType::STR_LITERAL: {
+                    Expr* expr = make_expr(ExprKind::STRING_LITERAL, make_type(ValueType::STRING), token.offset);
+                    expr->payload = token.payload;
+                    return expr;
+                }
+                case TokenType::BOOL_LITERAL: {
+                    Expr* expr = make_expr(ExprKind::BOOL_LITERAL, make_type(ValueType::BOOL), token.offset);
+                    expr->payload = token.payload;
+                    return expr;
+                }
+                case TokenType::OPEN_PARA: {
+                    Expr* expr = parse_expression();
+                    expect(TokenType::CLOSE_PARA, "Expected closing parenthesis");
+                    return expr;
+                }
+                case TokenType::THIS:
+                    if (this_type == -1) {
+                        --pointer;
+                        fail("this can only be used in member functions");
+                    }
+                    return make_this(token.offset);
+                case TokenType::NEW: {
+                    Token name_token = expect(TokenType::NAME, "Expected type name after new");
+                    int type_index = find_type(name_token.payload);
+                    if (type_index == -1) {
+                        --pointer;
+                        fail("Unknown type after new");
+                    }
+                    if (current_type() == TokenType::OPEN_PARA) {
+                        consume();
+                        expect(TokenType::CLOSE_PARA, "Expected closing parenthesis after new");
+                    }
+                    Expr* expr = make_expr(ExprKind::NEW, make_type(ValueType::OBJECT, type_index), token.offset);
+                    expr->index = type_index;
+                    return expr;
+                }
+                case TokenType::NAME:
+                    return parse_name(token);
+                default:
+                    --pointer;
+                    fail("Expected expression");
+            }
+        }
+
+        //Namen werden in dieser Reihenfolge aufgelöst: lokale Variablen und Parameter, Member von this, globale Namen
+        Expr* parse_name(const Token& name_token) {
+            uint32_t name = name_token.payload;
+            bool is_call = current_type() == TokenType::OPEN_PARA;
+            if (!is_call) {
+                uint32_t local = locals.lookup(name);
+                if (local != NO_SYMBOL) {
+                    Expr* expr = make_expr(ExprKind::LOCAL, local_types[locals.get(local).index], name_token.offset);
+                    expr->index = static_cast<int>(locals.get(local).index);
+                    return expr;
+                }
+            }
+            if (this_type != -1) {
+                int owner = -1;
+                uint32_t member = find_member(this_type, name, owner);
+                if (member != NO_SYMBOL) {
+                    bool is_method = info.symbols->get(member).kind == SymbolKind::MEMBER_FUNCTION;
+                    if (is_method && is_call)
+                        return make_method_call(make_this(name_token.offset), member, name_token.offset);
+                    if (!is_method && !is_call)
+                        return make_field(make_this(name_token.offset), owner, member, name_token.offset);
+                }
+            }
+            uint32_t symbol = info.symbols->lookup_in_scope(SymbolTable::GLOBAL_SCOPE, name);
+            if (symbol != NO_SYMBOL) {
+                const Symbol& global_symbol = info.symbols->get(symbol);
+                if (is_call && global_symbol.kind == SymbolKind::FUNCTION) {
+                    const FunctionInfo& callee = info.functions[global_symbol.index];
+                    Expr* call = make_expr(ExprKind::CALL, callee.return_value_type, name_token.offset);
+                    call->index = static_cast<int>(global_symbol.index);
+                    parse_arguments(call, callee);
+                    return call;
+                }
+                if (!is_call && global_symbol.kind == SymbolKind::GLOBAL_VAR) {
+                    Expr* expr = make_expr(ExprKind::GLOBAL, info.global_vars[global_symbol.index].value_type, name_token.offset);
+                    expr->index = static_cast<int>(global_symbol.index);
+                    return expr;
+                }
+            }
+            diagnostics.error(name_token.offset, (is_call ? "Unknown function: " : "Unknown identifier: ") + std::string(get_str_value(interner, name_token)));
+            throw SyntaxError();
+        }
+
+        //Anweisungen
+
+        Stmt* make_stmt(StmtKind kind) {
+            Stmt* stmt = arena.create<Stmt>();
+            stmt->kind = kind;
+            stmt->offset = location();
+            return stmt;
+        }
+
+        //liest Anweisungen bis zur schließenden Klammer bzw. bis zum Ende des Rumpfs. Eine fehlerhafte Anweisung wird
+        //übersprungen, erst beim Fehlerlimit wird abgebrochen
+        Stmt* parse_block_contents(bool until_close_curly) {
+            std::vector<Stmt*> statements;
+            bool reported_unreachable = false;
+            while (until_close_curly ? current_type() != TokenType::CLOSE_CURLY : !at_end()) {
+                if (until_close_curly && at_end())
+                    fail("Expected closing curly brace at end of block");
+                if (!reported_unreachable && !statements.empty() && statements.back()->kind == StmtKind::RETURN) {
+                    diagnostics.warning(location(), "Unreachable statement after return");
+                    reported_unreachable = true;
+                }
+                try {
+                    statements.push_back(parse_statement());
+                } catch (const SyntaxError&) {
+                    if (diagnostics.at_limit())
+                        throw;
+                    synchronize();
+                }
+            }
+            Stmt* block = make_stmt(StmtKind::BLOCK);
+            block->statements = copy_array(statements);
+            block->statement_count = static_cast<uint32_t>(statements.size());
+            return block;
+        }
+
+        Stmt* parse_statement() {
+            switch (current_type()) {
+                case TokenType::OPEN_CURLY: {
+                    consume();
+                    locals.enter_scope(ScopeKind::BLOCK);
+                    Stmt* block = parse_block_contents(true);
+                    locals.exit_scope();
+                    consume();
+                    return block;
+                }
+                case TokenType::RETURN: {
+                    Stmt* stmt = make_stmt(StmtKind::RETURN);
+                    consume();
+                    if (current_type() != TokenType::SEMICOLON) {
+                        stmt->value = parse_expression();
+                        if (function_info->return_value_type.kind == ValueType::VOID)
+                            report(stmt->offset, "Function without return type can not return a value");
+                        else
+                            check_assignable(function_info->return_value_type, stmt->value, "Returned value does not match the return type");
+                    } else if (function_info->return_value_type.kind != ValueType::VOID) {
+                        report(stmt->offset, "Expected return value");
+                    }
+                    expect(TokenType::SEMICOLON, "Expected semicolon after return statement");
+                    return stmt;
+                }
+                case TokenType::IF:
+                case TokenType::WHILE: {
+                    Stmt* stmt = make_stmt(current_type() == TokenType::IF ? StmtKind::IF : StmtKind::WHILE);
+                    bool is_if = consume().type == TokenType::IF;
+                    expect(TokenType::OPEN_PARA, "Expected open parenthesis before condition");
+                    stmt->value = parse_expression();
+                    if (stmt->value->type.kind != ValueType::BOOL && stmt->value->type.kind != ValueType::ERROR)
+                        report(stmt->value->offset, "Condition has to be a boolean");
+                    expect(TokenType::CLOSE_PARA, "Expected closing parenthesis after condition");
+                    stmt->body = parse_statement();
+                    if (is_if && current_type() == TokenType::ELSE) {
+                        consume();
+                        stmt->otherwise = parse_statement();
+                    }
+                    return stmt;
+                }
+                default:
+                    break;
+            }
+            Stmt* stmt = make_stmt(StmtKind::EXPR);
+            ValueType declared_type;
+            if (parse_declared_type(declared_type)) {
+                Token name_token = expect(TokenType::NAME, "Expected variable name after type");
+                stmt->kind = StmtKind::VAR_DECL;
+                if (current_type() == TokenType::EQUALS) {
+                    consume();
+                    stmt->value = parse_expression();
+                    check_assignable(declared_type, stmt->value, "Initial value does not match the variable type");
+                }
+                //erst nach dem Initialisierungsausdruck deklarieren, damit dieser die Variable nicht sieht
+                stmt->slot = static_cast<int>(local_types.size());
+                if (locals.declare(name_token.payload, SymbolKind::LOCAL_VAR, static_cast<uint32_t>(stmt->slot)) == NO_SYMBOL)
+                    report(name_token.offset, "Variable is already declared in this scope");
+                local_types.push_back(declared_type);
+                expect(TokenType::SEMICOLON, "Expected semicolon after variable declaration");
+                return stmt;
+            }
+            Expr* expr = parse_expression();
+            if (current_type() == TokenType::EQUALS) {
+                Token equals = consume();
+                if (expr->kind != ExprKind::LOCAL && expr->kind != ExprKind::GLOBAL && expr->kind != ExprKind::FIELD)
+                    report(equals.offset, "Left side of an assignment has to be a variable or field");
+                stmt->kind = StmtKind::ASSIGN;
+                stmt->target = expr;
+                stmt->value = parse_expression();
+                check_assignable(expr->type, stmt->value, "Assigned value does not match the type of the target");
+                expect(TokenType::SEMICOLON, "Expected semicolon after assignment");
+                return stmt;
+            }
+            stmt->value = expr;
+            expect(TokenType::SEMICOLON, "Expected semicolon after expression");
+            return stmt;
+        }
+    };
+}
+
+//Zwischenspeicher für bereits geparste Dateien. Der Schlüssel ist ein Hash über den Inhalt der Datei und die Version des Compilers,
+//unveränderte Dateien werden so ohne Tokenizer und Parser geladen. Ein Eintrag ist eine Datei, die per mmap gelesen wird
+namespace Cache {
+
+    using namespace Parsing;
+
+    constexpr char MAGIC[4] = {'C', 'R', 'L', 'C'};
+    //muss bei jeder Änderung am Format erhöht werden
+    constexpr uint32_t FORMAT_VERSION = 4;
+    //geht zusammen mit FORMAT_VERSION in jeden Schlüssel ein. Muss erhöht werden, wenn sich das Ergebnis von Tokenizer oder
+    //Deklarationsparser ändert, ohne dass sich das Format ändert, damit ein neuer Compiler keine Einträge eines alten liest
+    constexpr const char* COMPILER_VERSION = "coralc 0.25";
+
+    //zwei unabhängige 64 Bit Hashes, damit eine Kollision praktisch ausgeschlossen ist
+    struct Key {
+        uint64_t hash[2] = {0, 0};
+        uint64_t size = 0;
+    };
+
+    //Aufbau einer Cache Datei: Header, Zahlen des Interners, Offsets der Strings, Bytes der Strings, dann die Records in der Reihenfolge des Headers.
+    //Alle Abschnitte sind auf 4 Bytes ausgerichtet, Namen sind Indizes in die Stringtabelle
+    struct Header {
+        char magic[4];
+        uint32_t format_version;
+        uint64_t compiler_hash;
+        uint64_t content_hash[2];
+        uint64_t content_size;
+        //die ersten interned_count Strings sind der Interner der Datei in ID Reihenfolge, auf sie verweisen die Tokens
+        uint32_t interned_count;
+        uint32_t string_count;
+        uint32_t string_bytes;
+        uint32_t type_count;
+        uint32_t field_count;
+        uint32_t function_count;
+        uint32_t param_count;
+        uint32_t global_count;
+        uint32_t token_count;
+        uint32_t number_count;
+    };
+
+    //offset ist die Position der Deklaration im Quelltext, für Fehlermeldungen beim Zusammenführen
+    struct TypeRecord {
+        uint32_t name, super_type, first_field, field_count, offset;
+    };
+
+    struct FieldRecord {
+        uint32_t name, type, offset, flags;
+    };
+
+    enum FieldFlags : uint32_t {
+        FIELD_HOT = 1
+    };
+
+    struct FunctionRecord {
+        uint32_t name, return_type, first_param, param_count, first_token, token_count;
+        int32_t owner_type;
+        uint32_t flags, offset;
+    };
+
+    enum FunctionFlags : uint32_t {
+        FUNCTION_LINKED = 1,
+        FUNCTION_INTRINSIC = 2
+    };
+
+    struct ParamRecord {
+        uint32_t name, type;
+    };
+
+    struct GlobalRecord {
+        uint32_t name, type, first_token, token_count, offset;
+    };
+
+    //Token hat Padding Bytes, die nicht in die Datei sollen
+    struct TokenRecord {
+        uint32_t type, payload, offset;
+    };
+
+    uint64_t compiler_hash() {
+        return Util::hash_bytes(COMPILER_VERSION, strlen(COMPILER_VERSION), FORMAT_VERSION);
+    }
+
+    Key make_key(std::string_view content) {
+        Key key;
+        key.hash[0] = Util::hash_bytes(content.data(), content.size(), compiler_hash());
+        key.hash[1] = Util::hash_bytes(content.data(), content.size(), ~key.hash[0]);
+        key.size = content.size();
+        return key;
+    }
+
+    std::string entry_path(const std::string& directory, const Key& key) {
+        char name[40];
+        snprintf(name, sizeof(name), "%016llx%016llx.crlc", static_cast<unsigned long long>(key.hash[0]), static_cast<unsigned long long>(key.hash[1]));
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    class Writer final {
+    public:
+        explicit Writer(const Util::StringInterner& interner) : interner(interner) {
+            for (uint32_t id = 0; id < interner.size(); ++id)
+                strings.push_back(interner.get(id));
+        }
+
+        //Deklarationen wie Typnamen von Feldern stehen nicht unbedingt im Interner, die werden hinten angehängt
+        uint32_t string_id(const std::string& text) {
+            uint32_t id = interner.find(text);
+            if (id != UINT32_MAX)
+                return id;
+            for (size_t i = interner.size(); i < strings.size(); ++i) {
+                if (strings[i] == text)
+                    return static_cast<uint32_t>(i);
+            }
+            extra_strings.push_back(text);
+            strings.push_back(extra_strings.back());
+            return static_cast<uint32_t>(strings.size() - 1);
+        }
+
+        uint32_t add_tokens(const std::vector<Token>& code) {
+            uint32_t first = static_cast<uint32_t>(tokens.size());
+            for (const Token& token : code)
+                tokens.push_back({token.type, token.payload, token.offset});
+            return first;
+        }
+
+        std::vector<char> serialize(const Key& key, const ParseInfo& info) {
+            for (size_t i = 0; i < info.type_count; ++i) {
+                const TypeInfo& type_info = info.types[i];
+                types.push_back({string_id(type_info.name), string_id(type_info.super_type), static_cast<uint32_t>(fields.size()), static_cast<uint32_t>(type_info.field_count), type_info.offset});
+                for (size_t j = 0; j < type_info.field_count; ++j)
+                    fields.push_back({string_id(type_info.fields[j].name), string_id(type_info.fields[j].type), type_info.fields[j].offset,
+                                      type_info.fields[j].is_hot ? FIELD_HOT : 0u});
+            }
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                FunctionRecord record;
+                record.name = string_id(function_info.name);
+                record.return_type = string_id(function_info.return_type);
+                record.first_param = static_cast<uint32_t>(params.size());
+                record.param_count = static_cast<uint32_t>(function_info.param_count);
+                record.token_count = static_cast<uint32_t>(function_info.code.size());
+                record.first_token = add_tokens(function_info.code);
+                record.owner_type = function_info.owner_type;
+                record.flags = (function_info.is_linked ? static_cast<uint32_t>(FUNCTION_LINKED) : 0u) | (function_info.is_intrinsic ? static_cast<uint32_t>(FUNCTION_INTRINSIC) : 0u);
+                record.offset = function_info.offset;
+                functions.push_back(record);
+                for (size_t j = 0; j < function_info.param_count; ++j)
+                    params.push_back({string_id(function_info.param_names[j]), string_id(function_info.param_types[j])});
+            }
+            for (size_t i = 0; i < info.global_var_count; ++i) {
+                const GlobalVarInfo& global_info = info.global_vars[i];
+                GlobalRecord record;
+                record.name = string_id(global_info.name);
+                record.type = string_id(global_info.type);
+                record.token_count = static_cast<uint32_t>(global_info.initializer.size());
+                record.first_token = add_tokens(global_info.initializer);
+                record.offset = global_info.offset;
+                globals.push_back(record);
+            }
+
+            std::vector<uint32_t> offsets;
+            std::string bytes;
+            for (std::string_view text : strings) {
+                offsets.push_back(static_cast<uint32_t>(bytes.size()));
+                bytes.append(text.data(), text.size());
+            }
+            offsets.push_back(static_cast<uint32_t>(bytes.size()));
+            bytes.resize((bytes.size() + 3) & ~static_cast<size_t>(3), '\0');
+
+            Header header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.format_version = FORMAT_VERSION;
+            header.compiler_hash = compiler_hash();
+            header.content_hash[0] = key.hash[0];
+            header.content_hash[1] = key.hash[1];
+            header.content_size = key.size;
+            header.interned_count = static_cast<uint32_t>(interner.size());
+            header.string_count = static_cast<uint32_t>(strings.size());
+            header.string_bytes = static_cast<uint32_t>(bytes.size());
+            header.type_count = static_cast<uint32_t>(types.size());
+            header.field_count = static_cast<uint32_t>(fields.size());
+            header.function_count = static_cast<uint32_t>(functions.size());
+            header.param_count = static_cast<uint32_t>(params.size());
+            header.global_count = static_cast<uint32_t>(globals.size());
+            header.token_count = static_cast<uint32_t>(tokens.size());
+            header.number_count = static_cast<uint32_t>(interner.number_count());
+
+            std::vector<char> output;
+            append(output, &header, 1);
+            //direkt hinter dem Header, damit die doubles auf 8 Bytes ausgerichtet sind
+            for (uint32_t i = 0; i < header.number_count; ++i) {
+                double value = interner.get_number(i);
+                append(output, &value, 1);
+            }
+            append(output, offsets.data(), offsets.size());
+            append(output, bytes.data(), bytes.size());
+            append(output, types.data(), types.size());
+            append(output, fields.data(), fields.size());
+            append(output, functions.data(), functions.size());
+            append(output, params.data(), params.size());
+            append(output, globals.data(), globals.size());
+            append(output, tokens.data(), tokens.size());
+            return output;
+        }
+
+    private:
+        const Util::StringInterner& interner;
+        std::vector<std::string_view> strings;
+        std::deque<std::string> extra_strings;
+        std::vector<TypeRecord> types;
+        std::vector<FieldRecord> fields;
+        std::vector<FunctionRecord> functions;
+        std::vector<ParamRecord> params;
+        std::vector<GlobalRecord> globals;
+        std::vector<TokenRecord> tokens;
+
+        template<typename T>
+        static void append(std::vector<char>& output, const T* items, size_t count) {
+            const char* bytes = reinterpret_cast<const char*>(items);
+            output.insert(output.end(), bytes, bytes + sizeof(T) * count);
+        }
+    };
+
+    //liest die Abschnitte einer eingeblendeten Cache Datei, jeder Zugriff wird gegen die Dateigröße geprüft
+    class Reader final {
+    public:
+        Reader(const char* data, size_t size) : data(data), size(size) {
+        }
+
+        template<typename T>
+        const T* take(size_t count) {
+            if (offset > size || count > (size - offset) / sizeof(T)) {
+                valid = false;
+                return nullptr;
+            }
+            const T* items = reinterpret_cast<const T*>(data + offset);
+            offset += sizeof(T) * count;
+            return items;
+        }
+
+        bool is_valid() const {
+            return valid;
+        }
+
+    private:
+        const char* data;
+        size_t size;
+        size_t offset = 0;
+        bool valid = true;
+    };
+
+    //schreibt erst in eine temporäre Datei und benennt sie dann um, damit parallel laufende Compiler nie halbe Einträge sehen
+    bool store(const std::string& directory, const Key& key, const Util::StringInterner& interner, const ParseInfo& info) {
+        Writer writer(interner);
+        std::vector<char> output = writer.serialize(key, info);
+        std::error_code error_code;
+        std::filesystem::create_directories(directory, error_code);
+        std::string path = entry_path(directory, key);
+        std::string temporary_path = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(Util::WorkStealingPool::current_worker());
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+            file.write(output.data(), output.size());
+            if (!file)
+                return false;
+        }
+        std::filesystem::rename(temporary_path, path, error_code);
+        if (error_code) {
+            std::filesystem::remove(temporary_path, error_code);
+            return false;
+        }
+        return true;
+    }
+
+    //liefert false, wenn es keinen gültigen Eintrag gibt. Dann muss die Datei normal geparst werden
+    bool load(const std::string& directory, const Key& key, Util::StringInterner& interner, ParseInfo& info) {
+        Util::SourceBuffer buffer;
+        if (!buffer.open(entry_path(directory, key).c_str()))
+            return false;
+        //mit read() gelesene Puffer kommen von malloc und sind damit ausreichend ausgerichtet
+        Reader reader(buffer.data(), buffer.size());
+        const Header* header = reader.take<Header>(1);
+        if (header == nullptr || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->format_version != FORMAT_VERSION
+            || header->compiler_hash != compiler_hash() || header->content_hash[0] != key.hash[0] || header->content_hash[1] != key.hash[1]
+            || header->content_size != key.size || header->interned_count > header->string_count)
+            return false;
+        static_assert(sizeof(Header) % alignof(double) == 0, "numbers follow the header");
+        const double* numbers = reader.take<double>(header->number_count);
+        const uint32_t* offsets = reader.take<uint32_t>(static_cast<size_t>(header->string_count) + 1);
+        const char* bytes = reader.take<char>(header->string_bytes);
+        const TypeRecord* types = reader.take<TypeRecord>(header->type_count);
+        const FieldRecord* fields = reader.take<FieldRecord>(header->field_count);
+        const FunctionRecord* functions = reader.take<FunctionRecord>(header->function_count);
+        const ParamRecord* params = reader.take<ParamRecord>(header->param_count);
+        const GlobalRecord* globals = reader.take<GlobalRecord>(header->global_count);
+        const TokenRecord* tokens = reader.take<TokenRecord>(header->token_count);
+        if (!reader.is_valid())
+            return false;
+        for (uint32_t i = 0; i < header->string_count; ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > header->string_bytes)
+                return false;
+        }
+        auto string_at = [&](uint32_t id) {
+            return id < header->string_count ? std::string(bytes + offsets[id], offsets[id + 1] - offsets[id]) : std::string();
+        };
+        auto in_range = [](uint32_t first, uint32_t count, uint32_t total) {
+            return first <= total && count <= total - first;
+        };
+        auto copy_tokens = [&](uint32_t first, uint32_t count, std::vector<Token>& code) {
+            code.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                code[i].type = static_cast<TokenType>(tokens[first + i].type);
+                code[i].payload = tokens[first + i].payload;
+                code[i].offset = tokens[first + i].offset;
+            }
+        };
+        //erst alles prüfen, damit ein beschädigter Eintrag keine halb befüllte ParseInfo hinterlässt
+        for (uint32_t i = 0; i < header->type_count; ++i) {
+            if (!in_range(types[i].first_field, types[i].field_count, header->field_count))
+                return false;
+        }
+        for (uint32_t i = 0; i < header->function_count; ++i) {
+            if (!in_range(functions[i].first_param, functions[i].param_count, header->param_count) || !in_range(functions[i].first_token, functions[i].token_count, header->token_count)
+                || functions[i].owner_type < -1 || functions[i].owner_type >= static_cast<int32_t>(header->type_count))
+                return false;
+        }
+        for (uint32_t i = 0; i < header->global_count; ++i) {
+            if (!in_range(globals[i].first_token, globals[i].token_count, header->token_count))
+                return false;
+        }
+        for (uint32_t i = 0; i < header->token_count; ++i) {
+            if (tokens[i].type >= TokenType::TOKEN_TYPE_COUNT)
+                return false;
+            TokenType type = static_cast<TokenType>(tokens[i].type);
+            bool has_name = type == TokenType::NAME || type == TokenType::STR_LITERAL || type == TokenType::DECL_FUNCTION;
+            if (has_name && tokens[i].payload >= header->interned_count)
+                return false;
+            if (type == TokenType::NUM_LITERAL && (tokens[i].payload & NUMBER_INTERNED) && (tokens[i].payload & ~NUMBER_INTERNED) >= header->number_count)
+                return false;
+        }
+        //die IDs im neuen Interner stimmen nur dann mit denen beim Schreiben überein, wenn er leer ist und jeder String neu
+        //hinzukommt. Das wird vorher geprüft, damit das normale Parsen nach einem verworfenen Eintrag einen sauberen Interner vorfindet
+        if (header->interned_count == 0 || offsets[0] != offsets[1] || interner.size() != 1)
+            return false;
+        std::unordered_set<std::string_view> interned;
+        interned.reserve(header->interned_count);
+        for (uint32_t id = 1; id < header->interned_count; ++id) {
+            std::string_view text(bytes + offsets[id], offsets[id + 1] - offsets[id]);
+            if (text.empty() || !interned.insert(text).second)
+                return false;
+        }
+
+        for (uint32_t id = 1; id < header->interned_count; ++id)
+            interner.intern(std::string_view(bytes + offsets[id], offsets[id + 1] - offsets[id]));
+        for (uint32_t i = 0; i < header->number_count; ++i)
+            interner.add_number(numbers[i]);
+
+        info.type_count = header->type_count;
+        info.types = new TypeInfo[header->type_count];
+        for (uint32_t i = 0; i < header->type_count; ++i) {
+            TypeInfo& type_info = info.types[i];
+            type_info.name = string_at(types[i].name);
+            type_info.super_type = string_at(types[i].super_type);
+            type_info.offset = types[i].offset;
+            type_info.field_count = types[i].field_count;
+            type_info.fields = new FieldInfo[types[i].field_count];
+            for (uint32_t j = 0; j < types[i].field_count; ++j) {
+                type_info.fields[j].name = string_at(fields[types[i].first_field + j].name);
+                type_info.fields[j].type = string_at(fields[types[i].first_field + j].type);
+                type_info.fields[j].offset = fields[types[i].first_field + j].offset;
+                type_info.fields[j].is_hot = (fields[types[i].first_field + j].flags & FIELD_HOT) != 0;
+            }
+        }
+        info.function_count = header->function_count;
+        info.functions = new FunctionInfo[header->function_count];
+        for (uint32_t i = 0; i < header->function_count; ++i) {
+            const FunctionRecord& record = functions[i];
+            FunctionInfo& function_info = info.functions[i];
+            function_info.name = string_at(record.name);
+            function_info.return_type = string_at(record.return_type);
+            function_info.param_count = record.param_count;
+            function_info.param_types = new std::string[record.param_count];
+            function_info.param_names = new std::string[record.param_count];
+            for (uint32_t j = 0; j < record.param_count; ++j) {
+                function_info.param_names[j] = string_at(params[record.first_param + j].name);
+                function_info.param_types[j] = string_at(params[record.first_param + j].type);
+            }
+            copy_tokens(record.first_token, record.token_count, function_info.code);
+            function_info.owner_type = record.owner_type;
+            function_info.is_linked = (record.flags & FUNCTION_LINKED) != 0;
+            function_info.is_intrinsic = (record.flags & FUNCTION_INTRINSIC) != 0;
+            function_info.offset = record.offset;
+        }
+        info.global_var_count = header->global_count;
+        info.global_vars = new GlobalVarInfo[header->global_count];
+        for (uint32_t i = 0; i < header->global_count; ++i) {
+            GlobalVarInfo& global_info = info.global_vars[i];
+            global_info.name = string_at(globals[i].name);
+            global_info.type = string_at(globals[i].type);
+            global_info.offset = globals[i].offset;
+            copy_tokens(globals[i].first_token, globals[i].token_count, global_info.initializer);
+        }
+        info.symbols = nullptr;
+        return true;
+    }
+
+}
+
+namespace Driver {
+
+    using namespace Parsing;
+
+    struct Options {
+        std::vector<std::string> inputs;
+        bool streaming = false;
+        //0 bedeutet: ein Thread pro Kern
+        size_t jobs = 0;
+        //Rümpfe werden dann erst bei Bedarf über ensure_function_body geparst
+        bool decls_only = false;
+        //leer, wenn kein Cache benutzt werden soll
+        std::string cache_directory;
+        bool devirtualize = true;
+        bool fold_constants = true;
+        bool replace_scalars = true;
+        bool eliminate_dead_code = true;
+        //Wurzeln für eliminate_dead_code
+        std::vector<std::string> entry_points = {"main"};
+    };
+
+    //eine Eingabedatei mit eigenem Speicher und Interner, damit mehrere Dateien ohne Synchronisation parallel verarbeitet werden können
+    struct SourceFile {
+        std::string path;
+        //Position in der Eingabeliste, damit zeigen die Meldungen auf die Datei
+        uint32_t index;
+        Util::Arena arena;
+        Util::StringInterner interner;
+        ParseInfo info;
+        Diagnostics::DiagnosticList diagnostics;
+
+        SourceFile(std::string path, uint32_t index) : path(std::move(path)), index(index), interner(arena), diagnostics(index) {
+        }
+    };
+
+    //Klassenhierarchie des ganzen Programms: Typ IDs, Methodentabellen je Typ und für jeden Slot, ob er in einem Teilbaum
+    //überschrieben wird. Ein Slot, der unterhalb des statischen Typs nie überschrieben wird, hat genau ein mögliches Ziel
+    class ClassHierarchy final {
+    public:
+        void build(ParseInfo& info) {
+            this->info = &info;
+            subtypes.assign(info.type_count, {});
+            method_tables.assign(info.type_count, {});
+            overridden_below.assign(info.type_count, {});
+            method_slots.assign(info.function_count, -1);
+            members.assign(info.type_count, {});
+            for (size_t i = 0; i < info.function_count; ++i) {
+                if (info.functions[i].owner_type != -1)
+                    members[info.functions[i].owner_type].push_back(static_cast<uint32_t>(i));
+            }
+            std::vector<bool> done(info.type_count, false);
+            for (size_t i = 0; i < info.type_count; ++i) {
+                if (info.types[i].super_type_index != -1)
+                    subtypes[info.types[i].super_type_index].push_back(static_cast<int>(i));
+                build_table(static_cast<int>(i), done);
+            }
+            uint32_t next_id = 0;
+            for (size_t i = 0; i < info.type_count; ++i) {
+                if (info.types[i].super_type_index == -1)
+                    number_types(info, static_cast<int>(i), next_id);
+            }
+            done.assign(info.type_count, false);
+            for (size_t i = 0; i < info.type_count; ++i)
+                find_overrides(static_cast<int>(i), done);
+        }
+
+        //Slot einer Member Function in den Methodentabellen ihres Typs und aller Subtypen
+        int slot_of(size_t function_index) const {
+            return method_slots[function_index];
+        }
+
+        //Index der Member Function je Slot, geerbte eingeschlossen
+        const std::vector<uint32_t>& method_table(int type_index) const {
+            return method_tables[type_index];
+        }
+
+        const std::vector<int>& direct_subtypes(int type_index) const {
+            return subtypes[type_index];
+        }
+
+        //die einzige Member Function, die ein Aufruf von function_index auf einem Objekt mit statischem Typ type_index erreichen kann, sonst -1
+        int single_target(int type_index, size_t function_index) const {
+            int slot = method_slots[function_index];
+            if (slot == -1 || static_cast<size_t>(slot) >= method_tables[type_index].size() || overridden_below[type_index][slot])
+                return -1;
+            return static_cast<int>(method_tables[type_index][slot]);
+        }
+
+    private:
+        const ParseInfo* info = nullptr;
+        std::vector<std::vector<int>> subtypes;
+        std::vector<std::vector<uint32_t>> method_tables;
+        std::vector<std::vector<bool>> overridden_below;
+        std::vector<int> method_slots;
+        //Member Functions je Typ in Deklarationsreihenfolge
+        std::vector<std::vector<uint32_t>> members;
+
+        //Supertypen zuerst: ihre Slots bilden den Anfang der Tabelle des Subtyps, eine Überschreibung übernimmt den Slot
+        void build_table(int type_index, std::vector<bool>& done) {
+            if (done[type_index])
+                return;
+            done[type_index] = true;
+            std::vector<uint32_t>& table = method_tables[type_index];
+            int super_type = info->types[type_index].super_type_index;
+            if (super_type != -1) {
+                build_table(super_type, done);
+                table = method_tables[super_type];
+            }
+            for (uint32_t function_index : members[type_index]) {
+                int slot = -1;
+                const std::string& name = info->functions[function_index].name;
+                for (int type = super_type; type != -1 && slot == -1; type = info->types[type].super_type_index) {
+                    for (uint32_t inherited : members[type]) {
+                        if (info->functions[inherited].name == name) {
+                            slot = method_slots[inherited];
+                            break;
+                        }
+                    }
+                }
+                if (slot == -1) {
+                    slot = static_cast<int>(table.size());
+                    table.push_back(function_index);
+                }
+                method_slots[function_index] = slot;
+                table[slot] = function_index;
+            }
+        }
+
+        //Pre-Order: ein Typ bekommt seine ID vor den Subtypen, deren IDs danach lückenlos folgen
+        void number_types(ParseInfo& info, int type_index, uint32_t& next_id) {
+            TypeInfo& type_info = info.types[type_index];
+            type_info.type_id = next_id++;
+            for (int subtype : subtypes[type_index])
+                number_types(info, subtype, next_id);
+            type_info.last_subtype_id = next_id - 1;
+        }
+
+        //Subtypen zuerst: ein Slot ist unterhalb eines Typs überschrieben, wenn ein Subtyp ein anderes Ziel hat oder selbst überschrieben ist
+        void find_overrides(int type_index, std::vector<bool>& done) {
+            if (done[type_index])
+                return;
+            done[type_index] = true;
+            std::vector<bool>& overridden = overridden_below[type_index];
+            overridden.assign(method_tables[type_index].size(), false);
+            for (int subtype : subtypes[type_index]) {
+                find_overrides(subtype, done);
+                for (size_t slot = 0; slot < overridden.size(); ++slot)
+                    overridden[slot] = overridden[slot] || overridden_below[subtype][slot] || method_tables[subtype][slot] != method_tables[type_index][slot];
+            }
+        }
+    };
+
+    //das zusammengeführte Ergebnis aller Dateien. Alle Namens-IDs in info beziehen sich auf interner
+    struct Program {
+        Util::Arena arena;
+        Util::StringInterner interner;
+        ParseInfo info;
+        ClassHierarchy hierarchy;
+        //Member Function Aufrufe mit nur einem möglichen Ziel werden zu direkten Aufrufen
+        bool devirtualize = true;
+        //Objekte, die ihre Funktion nicht verlassen, werden in lokale Variablen pro Feld zerlegt
+        bool replace_scalars = true;
+        //nachgeparste Rümpfe werden gefaltet, is_constant und die Initialisierer sind dann schon fertig
+        bool fold_constants = true;
+        std::vector<std::unique_ptr<SourceFile>> files;
+        //ein Arena pro Worker für die Syntaxbäume der Rümpfe
+        std::vector<std::unique_ptr<Util::Arena>> body_arenas;
+        //Meldungen aus dem Zusammenführen und aus den Rümpfen, die der Dateien stehen in files
+        Diagnostics::DiagnosticList diagnostics;
+        //gesetzt von DeadCodeElimination, leer bedeutet alles ist erreichbar
+        std::vector<bool> live_functions;
+        std::vector<bool> live_types;
+        std::vector<bool> live_globals;
+
+        Program() : interner(arena) {
+        }
+
+        bool is_live_function(size_t index) const {
+            return live_functions.empty() || live_functions[index];
+        }
+
+        bool is_live_type(size_t index) const {
+            return live_types.empty() || live_types[index];
+        }
+
+        bool is_live_global(size_t index) const {
+            return live_globals.empty() || live_globals[index];
+        }
+    };
+
+    void add_manifest(const std::string& manifest_path, std::vector<std::string>& files);
+
+    void add_input(const std::string& argument, std::vector<std::string>& files) {
+        namespace fs = std::filesystem;
+        if (!argument.empty() && argument[0] == '@') {
+            add_manifest(argument.substr(1), files);
+            return;
+        }
+        std::error_code error_code;
+        if (fs::is_directory(argument, error_code)) {
+            //Verzeichnisse werden rekursiv nach .crl Dateien durchsucht, sortiert, damit die Reihenfolge nicht vom Dateisystem abhängt
+            std::vector<std::string> found;
+            for (fs::recursive_directory_iterator it(argument, error_code), end; it != end; it.increment(error_code)) {
+                if (error_code)
+                    break;
+                if (it->is_regular_file(error_code) && it->path().extension() == ".crl")
+                    found.push_back(it->path().string());
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(argument);
+        }
+    }
+
+    //eine Manifest Datei enthält einen Pfad pro Zeile, relativ zum Verzeichnis des Manifests. Zeilen mit # sind Kommentare
+    void add_manifest(const std::string& manifest_path, std::vector<std::string>& files) {
+        std::ifstream manifest(manifest_path);
+        if (!manifest) {
+            printf("Could not read manifest: %s\n", manifest_path.c_str());
+            exit(-1);
+        }
+        std::filesystem::path base = std::filesystem::path(manifest_path).parent_path();
+        std::string line;
+        while (std::getline(manifest, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+                continue;
+            size_t last = line.find_last_not_of(" \t\r");
+            std::string entry = line.substr(first, last - first + 1);
+            std::filesystem::path entry_path(entry);
+            if (entry_path.is_relative() && !base.empty())
+                entry_path = base / entry_path;
+            add_input(entry_path.string(), files);
+        }
+    }
+
+    std::vector<std::string> collect_inputs(const std::vector<std::string>& arguments) {
+        std::vector<std::string> files;
+        for (const std::string& argument : arguments)
+            add_input(argument, files);
+        return files;
+    }
+
+    void compile_file(SourceFile& file, const Options& options) {
+        Util::stats.add(Util::COUNTER_FILES, 1);
+        if (options.streaming) {
+            //Tokenizer und Parser laufen verschränkt, der Speicherbedarf wächst nicht mit der Dateigröße.
+            //Der Cache wird hier nicht benutzt, da sein Schlüssel den ganzen Inhalt der Datei braucht
+            Util::ChunkedReader reader;
+            if (!reader.open(file.path.c_str())) {
+                printf("Could not read file: %s\n", file.path.c_str());
+                exit(-1);
+            }
+            Tokenization::Tokenizer tokenizer(reader, file.interner, &file.diagnostics);
+            {
+                Util::PhaseTimer timer(Util::PHASE_PARSE);
+                Parser parser(tokenizer, file.interner, file.diagnostics, true);
+                file.info = parser.parse();
+            }
+            Util::stats.add(Util::COUNTER_BYTES, reader.bytes_read());
+            Util::stats.add(Util::COUNTER_TOKENS, tokenizer.token_count());
+            return;
+        }
+        Util::SourceBuffer source;
+        {
+            Util::PhaseTimer timer(Util::PHASE_READ);
+            source = Util::read_file(file.path.c_str());
+        }
+        Util::stats.add(Util::COUNTER_BYTES, source.size());
+        Cache::Key key;
+        if (!options.cache_directory.empty()) {
+            Util::PhaseTimer timer(Util::PHASE_CACHE);
+            key = Cache::make_key(source.view());
+            if (Cache::load(options.cache_directory, key, file.interner, file.info)) {
+                Util::stats.add(Util::COUNTER_CACHE_HITS, 1);
+                return;
+            }
+            Util::stats.add(Util::COUNTER_CACHE_MISSES, 1);
+        }
+        Tokenization::Tokenizer tokenizer(source.view(), file.interner, &file.diagnostics);
+        //gemessen wird derselbe Weg wie ohne --time-passes, nur für die Debug Ausgabe werden erst alle Tokens gelesen
+        if (Util::log_enabled(Util::TRACE)) {
+            Util::PhaseTimer timer(Util::PHASE_PARSE);
+            std::vector<Tokenization::Token> tokens = tokenizer.tokenize();
+            tokenizer.print_all_tokens();
+            Tokenization::VectorTokenSource token_source(tokens);
+            Parser parser(token_source, file.interner, file.diagnostics, true);
+            file.info = parser.parse();
+        } else {
+            Util::PhaseTimer timer(Util::PHASE_PARSE);
+            Parser parser(tokenizer, file.interner, file.diagnostics, true);
+            file.info = parser.parse();
+        }
+        Util::stats.add(Util::COUNTER_TOKENS, tokenizer.token_count());
+        //ein Cache, in den nicht geschrieben werden kann, verlangsamt nur, ist aber kein Fehler.
+        //Dateien mit Meldungen werden nicht gespeichert, sonst gingen die Meldungen beim nächsten Lauf verloren
+        if (!options.cache_directory.empty() && file.diagnostics.empty()) {
+            Util::PhaseTimer timer(Util::PHASE_CACHE);
+            Cache::store(options.cache_directory, key, file.interner, file.info);
+        }
+    }
+
+    //übernimmt die Namens-IDs eines Tokens aus dem Interner einer Datei in den des Programms. Die Zahlen der Datei
+    //stehen dort ab number_offset
+    void remap_tokens(std::vector<Token>& tokens, const std::vector<uint32_t>& remap, uint32_t number_offset) {
+        for (Token& token : tokens) {
+            if (token.type == TokenType::NAME || token.type == TokenType::STR_LITERAL || token.type == TokenType::DECL_FUNCTION)
+                token.payload = remap[token.payload];
+            else if (token.type == TokenType::NUM_LITERAL && (token.payload & NUMBER_INTERNED))
+                token.payload += number_offset;
+        }
+    }
+
+    //löst einen Typnamen aus einer Deklaration gegen die Typen des ganzen Programms auf
+    //ein unbekannter Typ wird an der Stelle file/offset gemeldet und ergibt ERROR
+    ValueType resolve_value_type(Program& program, const SymbolTable& symbols, const std::string& name, uint32_t file, uint32_t offset) {
+        ValueType value_type;
+        if (name == "number") {
+            value_type.kind = ValueType::NUMBER;
+        } else if (name == "string") {
+            value_type.kind = ValueType::STRING;
+        } else if (name == "bool") {
+            value_type.kind = ValueType::BOOL;
+        } else if (name == "numbers") {
+            value_type.kind = ValueType::NUMBERS;
+        } else {
+            uint32_t symbol = symbols.lookup_in_scope(SymbolTable::GLOBAL_SCOPE, program.interner.intern(name));
+            if (symbol == NO_SYMBOL || symbols.get(symbol).kind != SymbolKind::TYPE) {
+                program.diagnostics.report(Diagnostics::Severity::ERROR, file, offset, "Unknown type: " + name);
+                value_type.kind = ValueType::ERROR;
+                return value_type;
+            }
+            value_type.kind = ValueType::OBJECT;
+            value_type.type_index = static_cast<int>(symbols.get(symbol).index);
+        }
+        return value_type;
+    }
+
+    bool same_type(const ValueType& a, const ValueType& b) {
+        return a.kind == b.kind && (a.kind != ValueType::OBJECT || a.type_index == b.type_index);
+    }
+
+    bool same_signature(const FunctionInfo& a, const FunctionInfo& b) {
+        if (a.param_count != b.param_count || !same_type(a.return_value_type, b.return_value_type))
+            return false;
+        for (size_t i = 0; i < a.param_count; ++i) {
+            if (!same_type(a.param_value_types[i], b.param_value_types[i]))
+                return false;
+        }
+        return true;
+    }
+
+    //meldet einen doppelt vergebenen globalen Namen und verweist auf die erste Deklaration
+    void report_taken(Program& program, const SymbolTable& symbols, const std::vector<TypeInfo>& types, const std::vector<FunctionInfo>& functions,
+                      const std::vector<GlobalVarInfo>& global_vars, uint32_t name, const std::string& message, uint32_t file, uint32_t offset) {
+        program.diagnostics.report(Diagnostics::Severity::ERROR, file, offset, message);
+        uint32_t symbol = symbols.lookup_in_scope(SymbolTable::GLOBAL_SCOPE, name);
+        if (symbol == NO_SYMBOL)
+            return;
+        const Symbol& previous = symbols.get(symbol);
+        if (previous.kind == SymbolKind::TYPE)
+            program.diagnostics.report(Diagnostics::Severity::NOTE, types[previous.index].file, types[previous.index].offset, "Previous declaration is here");
+        else if (previous.kind == SymbolKind::FUNCTION)
+            program.diagnostics.report(Diagnostics::Severity::NOTE, functions[previous.index].file, functions[previous.index].offset, "Previous declaration is here");
+        else if (previous.kind == SymbolKind::GLOBAL_VAR)
+            program.diagnostics.report(Diagnostics::Severity::NOTE, global_vars[previous.index].file, global_vars[previous.index].offset, "Previous declaration is here");
+    }
+
+    //führt die Ergebnisse aller Dateien in Eingabereihenfolge zusammen. Verweise zwischen Dateien (Supertypen, Feldtypen)
+    //werden erst hier aufgelöst. Das Ergebnis hängt nur von der Reihenfolge der Eingaben ab, nicht von der Anzahl der Threads
+    ParseInfo merge_parse_infos(Program& program) {
+        std::vector<TypeInfo> types;
+        std::vector<FunctionInfo> functions;
+        std::vector<GlobalVarInfo> global_vars;
+        SymbolTable* symbols = new SymbolTable();
+
+        for (std::unique_ptr<SourceFile>& file : program.files) {
+            std::vector<uint32_t> remap(file->interner.size());
+            for (uint32_t id = 0; id < remap.size(); ++id)
+                remap[id] = program.interner.intern(file->interner.get(id));
+            uint32_t number_offset = static_cast<uint32_t>(program.interner.number_count());
+            for (uint32_t i = 0; i < file->interner.number_count(); ++i)
+                program.interner.add_number(file->interner.get_number(i));
+            ParseInfo& info = file->info;
+            int type_offset = static_cast<int>(types.size());
+            for (size_t i = 0; i < info.type_count; ++i) {
+                TypeInfo type_info = info.types[i];
+                type_info.file = file->index;
+                uint32_t name = program.interner.intern(type_info.name);
+                type_info.symbol = symbols->declare(name, SymbolKind::TYPE, static_cast<uint32_t>(types.size()));
+                //der doppelte Typ bleibt in der Liste, damit owner_type seiner Member Functions gültig bleibt. Er ist aber über
+                //seinen Namen nicht erreichbar
+                if (type_info.symbol == NO_SYMBOL)
+                    report_taken(program, *symbols, types, functions, global_vars, name, "Identifier is already taken: " + type_info.name, type_info.file, type_info.offset);
+                type_info.member_scope = symbols->create_scope(ScopeKind::TYPE_MEMBER, SymbolTable::GLOBAL_SCOPE);
+                type_info.super_type_index = -1;
+                types.push_back(type_info);
+            }
+            for (size_t i = 0; i < info.function_count; ++i) {
+                FunctionInfo function_info = info.functions[i];
+                function_info.file = file->index;
+                remap_tokens(function_info.code, remap, number_offset);
+                uint32_t name = program.interner.intern(function_info.name);
+                uint32_t index = static_cast<uint32_t>(functions.size());
+                if (function_info.owner_type != -1) {
+                    function_info.owner_type += type_offset;
+                    function_info.symbol = symbols->declare_in_scope(types[function_info.owner_type].member_scope, name, SymbolKind::MEMBER_FUNCTION, index);
+                    if (function_info.symbol == NO_SYMBOL) {
+                        program.diagnostics.report(Diagnostics::Severity::ERROR, function_info.file, function_info.offset, "Duplicate identifier: " + function_info.name);
+                        continue;
+                    }
+                } else {
+                    function_info.symbol = symbols->declare(name, SymbolKind::FUNCTION, index);
+                    if (function_info.symbol == NO_SYMBOL) {
+                        report_taken(program, *symbols, types, functions, global_vars, name, "Identifier is already taken: " + function_info.name, function_info.file, function_info.offset);
+                        continue;
+                    }
+                }
+                functions.push_back(function_info);
+            }
+            for (size_t i = 0; i < info.global_var_count; ++i) {
+                GlobalVarInfo global_info = info.global_vars[i];
+                global_info.file = file->index;
+                remap_tokens(global_info.initializer, remap, number_offset);
+                uint32_t name = program.interner.intern(global_info.name);
+                global_info.symbol = symbols->declare(name, SymbolKind::GLOBAL_VAR, static_cast<uint32_t>(global_vars.size()));
+                if (global_info.symbol == NO_SYMBOL) {
+                    report_taken(program, *symbols, types, functions, global_vars, name, "Identifier is already taken: " + global_info.name, global_info.file, global_info.offset);
+                    continue;
+                }
+                global_vars.push_back(global_info);
+            }
+            delete info.symbols;
+            info.symbols = nullptr;
+        }
+
+        //jetzt sind alle Typen bekannt: Supertypen und Feldtypen auflösen
+        for (TypeInfo& type_info : types) {
+            if (!type_info.super_type.empty()) {
+                uint32_t symbol = symbols->lookup_in_scope(SymbolTable::GLOBAL_SCOPE, program.interner.intern(type_info.super_type));
+                if (symbol == NO_SYMBOL || symbols->get(symbol).kind != SymbolKind::TYPE)
+                    program.diagnostics.report(Diagnostics::Severity::ERROR, type_info.file, type_info.offset, "Type in from clause does not exist: " + type_info.super_type);
+                else
+                    type_info.super_type_index = static_cast<int>(symbols->get(symbol).index);
+            }
+            for (size_t j = 0; j < type_info.field_count; ++j) {
+                FieldInfo& field_info = type_info.fields[j];
+                field_info.value_type = resolve_value_type(program, *symbols, field_info.type, type_info.file, field_info.offset);
+                field_info.symbol = symbols->declare_in_scope(type_info.member_scope, program.interner.intern(field_info.name), SymbolKind::FIELD, static_cast<uint32_t>(j));
+                if (field_info.symbol == NO_SYMBOL)
+                    program.diagnostics.report(Diagnostics::Severity::ERROR, type_info.file, field_info.offset, "Duplicate identifier: " + field_info.name);
+            }
+        }
+        for (FunctionInfo& function_info : functions) {
+            function_info.return_value_type = function_info.return_type.empty() ? ValueType() : resolve_value_type(program, *symbols, function_info.return_type, function_info.file, function_info.offset);
+            function_info.param_value_types = new ValueType[function_info.param_count];
+            for (size_t j = 0; j < function_info.param_count; ++j)
+                function_info.param_value_types[j] = resolve_value_type(program, *symbols, function_info.param_types[j], function_info.file, function_info.offset);
+        }
+        for (GlobalVarInfo& global_info : global_vars)
+            global_info.value_type = resolve_value_type(program, *symbols, global_info.type, global_info.file, global_info.offset);
+        //Vererbungszyklen sind erst über Dateigrenzen hinweg möglich. Ein Zyklus wird an dem gemeldeten Typ aufgebrochen,
+        //damit die folgenden Schleifen über die Supertypen terminieren
+        for (size_t i = 0; i < types.size(); ++i) {
+            int current_type = types[i].super_type_index;
+            for (size_t steps = 0; current_type != -1; ++steps) {
+                if (steps > types.size() || current_type == static_cast<int>(i)) {
+                    program.diagnostics.report(Diagnostics::Severity::ERROR, types[i].file, types[i].offset, "Cyclic inheritance: " + types[i].name);
+                    types[i].super_type_index = -1;
+                    break;
+                }
+                current_type = types[current_type].super_type_index;
+            }
+        }
+        //Member Functions dürfen geerbte Member Functions mit gleicher Signatur überschreiben, aber keine Felder verdecken
+        for (FunctionInfo& function_info : functions) {
+            if (function_info.owner_type == -1)
+                continue;
+            uint32_t name = program.interner.intern(function_info.name);
+            for (int super_type = types[function_info.owner_type].super_type_index; super_type != -1; super_type = types[super_type].super_type_index) {
+                uint32_t symbol = symbols->lookup_in_scope(types[super_type].member_scope, name);
+                if (symbol == NO_SYMBOL)
+                    continue;
+                if (symbols->get(symbol).kind != SymbolKind::MEMBER_FUNCTION || !same_signature(function_info, functions[symbols->get(symbol).index])) {
+                    program.diagnostics.report(Diagnostics::Severity::ERROR, function_info.file, function_info.offset,
+                        "Invalid override: " + types[function_info.owner_type].name + "." + function_info.name);
+                    if (symbols->get(symbol).kind == SymbolKind::MEMBER_FUNCTION) {
+                        const FunctionInfo& overridden = functions[symbols->get(symbol).index];
+                        program.diagnostics.report(Diagnostics::Severity::NOTE, overridden.file, overridden.offset, "Overridden function is declared here");
+                    }
+                }
+                break;
+            }
+        }
+
+        ParseInfo merged;
+        merged.type_count = types.size();
+        merged.types = new TypeInfo[types.size()];
+        for (size_t i = 0; i < types.size(); ++i)
+            merged.types[i] = types[i];
+        merged.function_count = functions.size();
+        merged.functions = new FunctionInfo[functions.size()];
+        for (size_t i = 0; i < functions.size(); ++i)
+            merged.functions[i] = functions[i];
+        merged.global_var_count = global_vars.size();
+        merged.global_vars = new GlobalVarInfo[global_vars.size()];
+        for (size_t i = 0; i < global_vars.size(); ++i)
+            merged.global_vars[i] = global_vars[i];
+        merged.symbols = symbols;
+        return merged;
+    }
+
+    //jedes Objekt beginnt mit einem Zeiger auf seinen Typ
+    constexpr uint32_t OBJECT_HEADER_SIZE = 8;
+    constexpr uint32_t CACHE_LINE_SIZE = 64;
+
+    //Felder werden unverpackt gespeichert, die Ausrichtung ist gleich der Größe
+    uint32_t field_size(const ValueType& value_type) {
+        return value_type.kind == ValueType::BOOL ? 1 : 8;
+    }
+
+    uint32_t align_up(uint32_t value, uint32_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    //freier Bereich zwischen Feldern, den Subtypen noch füllen können
+    struct Hole {
+        uint32_t offset, size;
+    };
+
+    class LayoutEngine final {
+    public:
+        explicit LayoutEngine(Program& program) : program(program), types(program.info.types), type_count(program.info.type_count) {
+        }
+
+        void run() {
+            holes.resize(type_count);
+            done.assign(type_count, false);
+            for (size_t i = 0; i < type_count; ++i)
+                layout(static_cast<int>(i));
+        }
+
+    private:
+        Program& program;
+        TypeInfo* types;
+        size_t type_count;
+        std::vector<std::vector<Hole>> holes;
+        std::vector<bool> done;
+
+        //die Felder des Supertyps bleiben, wo sie sind, damit ein Objekt auch als Supertyp gelesen werden kann. Die eigenen Felder
+        //kommen heiße zuerst und innerhalb davon nach fallender Größe, jeweils in die erste passende Lücke oder ans Ende
+        void layout(int type_index) {
+            if (done[type_index])
+                return;
+            done[type_index] = true;
+            TypeInfo& type_info = types[type_index];
+            uint32_t end = OBJECT_HEADER_SIZE, declared_end = OBJECT_HEADER_SIZE, field_bytes = 0;
+            std::vector<Hole>& free_holes = holes[type_index];
+            if (type_info.super_type_index != -1) {
+                const TypeInfo& super_type = types[type_info.super_type_index];
+                layout(type_info.super_type_index);
+                end = super_type.data_size;
+                declared_end = super_type.declared_size;
+                field_bytes = super_type.size - super_type.padding - OBJECT_HEADER_SIZE;
+                free_holes = holes[type_info.super_type_index];
+            }
+            std::vector<uint32_t> order(type_info.field_count);
+            for (uint32_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                const FieldInfo& first = type_info.fields[a];
+                const FieldInfo& second = type_info.fields[b];
+                if (first.is_hot != second.is_hot)
+                    return first.is_hot;
+                return field_size(first.value_type) > field_size(second.value_type);
+            });
+            for (uint32_t index : order) {
+                FieldInfo& field_info = type_info.fields[index];
+                uint32_t size = field_size(field_info.value_type);
+                field_info.layout_offset = place(free_holes, end, size);
+                field_bytes += size;
+                if (field_info.is_hot && field_info.layout_offset + size > CACHE_LINE_SIZE)
+                    program.diagnostics.report(Diagnostics::Severity::WARNING, type_info.file, field_info.offset, "Hot field " + field_info.name + " does not fit into the first cache line");
+            }
+            for (size_t i = 0; i < type_info.field_count; ++i) {
+                uint32_t size = field_size(type_info.fields[i].value_type);
+                declared_end = align_up(declared_end, size) + size;
+            }
+            type_info.alignment = OBJECT_HEADER_SIZE;
+            type_info.data_size = end;
+            type_info.size = align_up(end, type_info.alignment);
+            type_info.padding = type_info.size - OBJECT_HEADER_SIZE - field_bytes;
+            type_info.declared_size = align_up(declared_end, type_info.alignment);
+        }
+
+        static uint32_t place(std::vector<Hole>& free_holes, uint32_t& end, uint32_t size) {
+            for (size_t i = 0; i < free_holes.size(); ++i) {
+                Hole hole = free_holes[i];
+                uint32_t offset = align_up(hole.offset, size);
+                if (offset + size > hole.offset + hole.size)
+                    continue;
+                free_holes.erase(free_holes.begin() + i);
+                if (offset + size < hole.offset + hole.size)
+                    free_holes.insert(free_holes.begin() + i, {offset + size, hole.offset + hole.size - offset - size});
+                if (offset > hole.offset)
+                    free_holes.insert(free_holes.begin() + i, {hole.offset, offset - hole.offset});
+                return offset;
+            }
+            uint32_t offset = align_up(end, size);
+            if (offset > end)
+                free_holes.push_back({end, offset - end});
+            end = offset + size;
+            return offset;
+        }
+    };
+
+    //Speicherlayout aller Typen mit Offsets, Füllbytes und dem Vergleich zur Deklarationsreihenfolge
+    void print_layout_report(const Program& program) {
+        const ParseInfo& info = program.info;
+        uint64_t total_padding = 0, total_size = 0, total_declared_size = 0;
+        for (size_t i = 0; i < info.type_count; ++i) {
+            const TypeInfo& type_info = info.types[i];
+            printf("%s", type_info.name.c_str());
+            if (type_info.super_type_index != -1)
+                printf(" (from %s)", type_info.super_type.c_str());
+            printf(": %u bytes, align %u, %u bytes padding, %u bytes in declaration order\n", type_info.size, type_info.alignment, type_info.padding,
+                   type_info.declared_size);
+            struct Entry {
+                uint32_t offset, size;
+                const FieldInfo* field;
+                const TypeInfo* owner;
+            };
+            std::vector<Entry> entries;
+            for (int type = static_cast<int>(i); type != -1; type = info.types[type].super_type_index) {
+                const TypeInfo& owner = info.types[type];
+                for (size_t j = 0; j < owner.field_count; ++j)
+                    entries.push_back({owner.fields[j].layout_offset, field_size(owner.fields[j].value_type), &owner.fields[j], &owner});
+            }
+            std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+                return a.offset < b.offset;
+            });
+            printf("    %6s %5s  %s\n", "offset", "size", "field");
+            printf("    %6u %5u  <header>\n", 0u, OBJECT_HEADER_SIZE);
+            uint32_t position = OBJECT_HEADER_SIZE;
+            for (const Entry& entry : entries) {
+                if (entry.offset > position)
+                    printf("    %6u %5u  <padding>\n", position, entry.offset - position);
+                printf("    %6u %5u  %s%s %s", entry.offset, entry.size, entry.field->is_hot ? "hot " : "", entry.field->type.c_str(), entry.field->name.c_str());
+                if (entry.owner != &type_info)
+                    printf(" (%s)", entry.owner->name.c_str());
+                printf("\n");
+                position = entry.offset + entry.size;
+            }
+            if (type_info.size > position)
+                printf("    %6u %5u  <padding>\n", position, type_info.size - position);
+            total_padding += type_info.padding;
+            total_size += type_info.size;
+            total_declared_size += type_info.declared_size;
+        }
+        printf("%zu types, %llu bytes, %llu bytes padding, %llu bytes in declaration order\n", info.type_count, static_cast<unsigned long long>(total_size),
+               static_cast<unsigned long long>(total_padding), static_cast<unsigned long long>(total_declared_size));
+    }
+
+    //zweite Phase: Rümpfe und Initialisierungsausdrücke sind unabhängig voneinander und werden parallel geparst
+    void parse_bodies(Program& program, Util::WorkStealingPool& pool) {
+        while (program.body_arenas.size() < pool.size())
+            program.body_arenas.emplace_back(new Util::Arena());
+        ParseInfo& info = program.info;
+        //eine Liste pro Rumpf, damit die Reihenfolge der Meldungen nicht von der Verteilung auf die Threads abhängt
+        std::vector<Diagnostics::DiagnosticList> diagnostics(info.function_count + info.global_var_count);
+        pool.parallel_for(diagnostics.size(), [&](size_t index) {
+            BodyParser body_parser(info, program.interner, *program.body_arenas[Util::WorkStealingPool::current_worker()], diagnostics[index]);
+            if (index < info.function_count) {
+                FunctionInfo& function_info = info.functions[index];
+                if (!function_info.is_linked && !function_info.is_intrinsic)
+                    function_info.body = body_parser.parse_function_body(function_info);
+            } else {
+                GlobalVarInfo& global_info = info.global_vars[index - info.function_count];
+                if (!global_info.initializer.empty())
+                    global_info.initializer_expr = body_parser.parse_initializer(global_info);
+                global_info.initializer_parsed = true;
+            }
+        });
+        for (const Diagnostics::DiagnosticList& list : diagnostics)
+            program.diagnostics.append(list);
+    }
+
+    void devirtualize_statement(const Program& program, Stmt* stmt);
+
+    void devirtualize_expression(const Program& program, Expr* expr) {
+        if (expr == nullptr)
+            return;
+        devirtualize_expression(program, expr->left);
+        devirtualize_expression(program, expr->right);
+        for (uint32_t i = 0; i < expr->arg_count; ++i)
+            devirtualize_expression(program, expr->args[i]);
+        if (expr->kind != ExprKind::METHOD_CALL || expr->left->type.kind != ValueType::OBJECT)
+            return;
+        int target = program.hierarchy.single_target(expr->left->type.type_index, expr->index);
+        if (target == -1) {
+            Util::stats.add(Util::COUNTER_VIRTUAL_CALLS, 1);
+            return;
+        }
+        expr->kind = ExprKind::DIRECT_METHOD_CALL;
+        expr->index = target;
+        Util::stats.add(Util::COUNTER_DEVIRTUALIZED_CALLS, 1);
+    }
+
+    void devirtualize_statement(const Program& program, Stmt* stmt) {
+        if (stmt == nullptr)
+            return;
+        devirtualize_expression(program, stmt->target);
+        devirtualize_expression(program, stmt->value);
+        devirtualize_statement(program, stmt->body);
+        devirtualize_statement(program, stmt->otherwise);
+        for (uint32_t i = 0; i < stmt->statement_count; ++i)
+            devirtualize_statement(program, stmt->statements[i]);
+    }
+
+    //ersetzt Member Function Aufrufe, die laut Klassenhierarchie nur ein Ziel haben, durch direkte Aufrufe. Läuft parallel über die Rümpfe
+    void devirtualize(Program& program, Util::WorkStealingPool& pool) {
+        ParseInfo& info = program.info;
+        pool.parallel_for(info.function_count + info.global_var_count, [&](size_t index) {
+            if (index < info.function_count) {
+                if (info.functions[index].body != nullptr)
+                    devirtualize_statement(program, info.functions[index].body->block);
+            } else {
+                devirtualize_expression(program, info.global_vars[index - info.function_count].initializer_expr);
+            }
+        });
+    }
+
+    //wie ensure_function_body für den Initialisierer einer globalen Variable, nullptr wenn es keinen gibt. Nicht threadsicher
+    Expr* ensure_global_initializer(Program& program, size_t global_index) {
+        GlobalVarInfo& global_info = program.info.global_vars[global_index];
+        if (!global_info.initializer_parsed) {
+            global_info.initializer_parsed = true;
+            if (!global_info.initializer.empty()) {
+                if (program.body_arenas.empty())
+                    program.body_arenas.emplace_back(new Util::Arena());
+                BodyParser body_parser(program.info, program.interner, *program.body_arenas[0], program.diagnostics);
+                global_info.initializer_expr = body_parser.parse_initializer(global_info);
+                if (program.devirtualize)
+                    devirtualize_expression(program, global_info.initializer_expr);
+            }
+        }
+        return global_info.initializer_expr;
+    }
+
+    //faltet Ausdrücke aus Literalen und ersetzt globale Variablen, die nie zugewiesen werden und ein konstantes Ergebnis haben,
+    //durch ihren Wert. Die Knoten werden an Ort und Stelle umgeschrieben. Läuft sequentiell, da neue Strings interniert werden
+    class ConstantFolder final {
+    public:
+        explicit ConstantFolder(Program& program) : program(program), info(program.info) {
+        }
+
+        void run() {
+            assigned.assign(info.global_var_count, false);
+            for (size_t i = 0; i < info.function_count; ++i) {
+                if (info.functions[i].body != nullptr)
+                    find_assignments(info.functions[i].body->block);
+            }
+            fold_globals();
+            for (size_t i = 0; i < info.function_count; ++i) {
+                if (info.functions[i].body != nullptr)
+                    fold_statement(info.functions[i].body->block);
+            }
+        }
+
+        //für --decls-only: nur Rümpfe, in denen laut Tokens ein globaler Name vor = steht, werden zur Probe geparst und
+        //wieder verworfen. Die Rümpfe selbst faltet ensure_function_body über fold_body, sobald sie gebraucht werden
+        void run_declarations_only() {
+            assigned.assign(info.global_var_count, false);
+            //die Probe-Rümpfe werden am Ende wieder verworfen
+            Util::Arena scratch;
+            for (size_t i = 0; i < info.function_count; ++i) {
+                FunctionInfo& function_info = info.functions[i];
+                if (function_info.is_linked || function_info.is_intrinsic || !may_assign_global(function_info.code))
+                    continue;
+                //die Meldungen kommen beim eigentlichen Parsen
+                Diagnostics::DiagnosticList ignored(function_info.file);
+                BodyParser body_parser(info, program.interner, scratch, ignored);
+                find_assignments(body_parser.parse_function_body(function_info)->block);
+            }
+            for (size_t i = 0; i < info.global_var_count; ++i)
+                ensure_global_initializer(program, i);
+            fold_globals();
+        }
+
+        void fold_body(FunctionBody* body) {
+            fold_statement(body->block);
+        }
+
+    private:
+        enum State : uint8_t {
+            UNVISITED,
+            ACTIVE,
+            DONE
+        };
+
+        Program& program;
+        ParseInfo& info;
+        //leer, wenn nur einzelne Rümpfe gefaltet werden. Dann gilt is_constant und alle Initialisierer sind fertig
+        std::vector<bool> assigned;
+        std::vector<State> state;
+
+        static bool is_literal(const Expr* expr) {
+            return expr->kind == ExprKind::NUMBER_LITERAL || expr->kind == ExprKind::STRING_LITERAL || expr->kind == ExprKind::BOOL_LITERAL;
+        }
+
+        void find_assignments(const Stmt* stmt) {
+            if (stmt == nullptr)
+                return;
+            if (stmt->kind == StmtKind::ASSIGN && stmt->target->kind == ExprKind::GLOBAL)
+                assigned[stmt->target->index] = true;
+            find_assignments(stmt->body);
+            find_assignments(stmt->otherwise);
+            for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                find_assignments(stmt->statements[i]);
+        }
+
+        //is_constant muss vorher für alle feststehen, da fold_global vorgreift
+        void fold_globals() {
+            for (size_t i = 0; i < info.global_var_count; ++i)
+                info.global_vars[i].is_constant = !assigned[i];
+            state.assign(info.global_var_count, UNVISITED);
+            for (size_t i = 0; i < info.global_var_count; ++i)
+                fold_global(i);
+        }
+
+        //ein Ziel einer Zuweisung endet mit seinem Namen oder schließenden Klammern, ein Feld folgt auf einen Punkt
+        bool may_assign_global(const std::vector<Token>& code) const {
+            for (size_t i = 0; i < code.size(); ++i) {
+                if (code[i].type != TokenType::NAME || (i > 0 && code[i - 1].type == TokenType::PERIOD))
+                    continue;
+                size_t next = i + 1;
+                while (next < code.size() && code[next].type == TokenType::CLOSE_PARA)
+                    ++next;
+                if (next == code.size() || code[next].type != TokenType::EQUALS)
+                    continue;
+                uint32_t symbol = info.symbols->lookup_in_scope(SymbolTable::GLOBAL_SCOPE, code[i].payload);
+                if (symbol != NO_SYMBOL && info.symbols->get(symbol).kind == SymbolKind::GLOBAL_VAR)
+                    return true;
+            }
+            return false;
+        }
+
+        //ein Zyklus zwischen Initialisierungen bleibt ungefaltet
+        void fold_global(size_t index) {
+            if (state[index] != UNVISITED)
+                return;
+            state[index] = ACTIVE;
+            if (info.global_vars[index].initializer_expr != nullptr)
+                fold_expression(info.global_vars[index].initializer_expr);
+            state[index] = DONE;
+        }
+
+        void fold_statement(Stmt* stmt) {
+            if (stmt == nullptr)
+                return;
+            //das Ziel einer Zuweisung bleibt stehen, nur sein Objekt wird gefaltet
+            if (stmt->target != nullptr && stmt->target->left != nullptr)
+                fold_expression(stmt->target->left);
+            if (stmt->value != nullptr)
+                fold_expression(stmt->value);
+            fold_statement(stmt->body);
+            fold_statement(stmt->otherwise);
+            for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                fold_statement(stmt->statements[i]);
+        }
+
+        void fold_expression(Expr* expr) {
+            if (expr->left != nullptr)
+                fold_expression(expr->left);
+            if (expr->right != nullptr)
+                fold_expression(expr->right);
+            for (uint32_t i = 0; i < expr->arg_count; ++i)
+                fold_expression(expr->args[i]);
+            switch (expr->kind) {
+                case ExprKind::GLOBAL: {
+                    if (!info.global_vars[expr->index].is_constant)
+                        return;
+                    bool done = state.empty();
+                    if (!done) {
+                        fold_global(expr->index);
+                        done = state[expr->index] == DONE;
+                    }
+                    const Expr* initializer = info.global_vars[expr->index].initializer_expr;
+                    if (initializer != nullptr && done && is_literal(initializer))
+                        make_literal(expr, initializer->kind, initializer->payload, initializer->number);
+                    return;
+                }
+                case ExprKind::UNARY:
+                    if (expr->op == TokenType::BANG && expr->left->kind == ExprKind::BOOL_LITERAL)
+                        make_literal(expr, ExprKind::BOOL_LITERAL, expr->left->payload ^ 1, 0);
+                    else if (expr->op == TokenType::MINUS && expr->left->kind == ExprKind::NUMBER_LITERAL)
+                        make_literal(expr, ExprKind::NUMBER_LITERAL, 0, -expr->left->number);
+                    return;
+                case ExprKind::BINARY:
+                    //fehlerhafte Ausdrücke wurden schon gemeldet und bleiben, wie sie sind
+                    if (expr->type.kind != ValueType::ERROR && is_literal(expr->left) && expr->left->kind == expr->right->kind)
+                        fold_binary(expr);
+                    return;
+                default:
+                    return;
+            }
+        }
+
+        //rechnet wie der Interpreter in double, damit gefaltete und ausgeführte Ausdrücke dasselbe Ergebnis haben
+        void fold_binary(Expr* expr) {
+            const Expr* left = expr->left;
+            const Expr* right = expr->right;
+            if (left->kind == ExprKind::NUMBER_LITERAL) {
+                double a = left->number, b = right->number;
+                switch (expr->op) {
+                    case TokenType::PLUS: make_literal(expr, ExprKind::NUMBER_LITERAL, 0, a + b); return;
+                    case TokenType::MINUS: make_literal(expr, ExprKind::NUMBER_LITERAL, 0, a - b); return;
+                    case TokenType::STAR: make_literal(expr, ExprKind::NUMBER_LITERAL, 0, a * b); return;
+                    case TokenType::SLASH: make_literal(expr, ExprKind::NUMBER_LITERAL, 0, a / b); return;
+                    case TokenType::PERCENT: make_literal(expr, ExprKind::NUMBER_LITERAL, 0, fmod(a, b)); return;
+                    case TokenType::LESS: make_literal(expr, ExprKind::BOOL_LITERAL, a < b, 0); return;
+                    case TokenType::GREATER: make_literal(expr, ExprKind::BOOL_LITERAL, a > b, 0); return;
+                    case TokenType::LESS_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a <= b, 0); return;
+                    case TokenType::GREATER_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a >= b, 0); return;
+                    case TokenType::EQUALS_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a == b, 0); return;
+                    case TokenType::NOT_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a != b, 0); return;
+                    default: return;
+                }
+            }
+            //internierte Strings sind genau dann gleich, wenn ihre IDs gleich sind
+            uint32_t a = left->payload, b = right->payload;
+            switch (expr->op) {
+                case TokenType::PLUS:
+                    if (left->kind == ExprKind::STRING_LITERAL) {
+                        std::string text(program.interner.get(a));
+                        text += program.interner.get(b);
+                        make_literal(expr, ExprKind::STRING_LITERAL, program.interner.intern(text), 0);
+                    }
+                    return;
+                case TokenType::EQUALS_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a == b, 0); return;
+                case TokenType::NOT_EQUALS: make_literal(expr, ExprKind::BOOL_LITERAL, a != b, 0); return;
+                case TokenType::AND_AND: make_literal(expr, ExprKind::BOOL_LITERAL, a & b, 0); return;
+                case TokenType::OR_OR: make_literal(expr, ExprKind::BOOL_LITERAL, a | b, 0); return;
+                default: return;
+            }
+        }
+
+        static void make_literal(Expr* expr, ExprKind kind, uint32_t payload, double number) {
+            expr->kind = kind;
+            if (kind == ExprKind::NUMBER_LITERAL)
+                expr->number = number;
+            else
+                expr->payload = payload;
+            expr->left = nullptr;
+            expr->right = nullptr;
+            Util::stats.add(Util::COUNTER_FOLDED_EXPRESSIONS, 1);
+        }
+    };
+
+    //zerlegt Objekte, die ihre Funktion nicht verlassen, in einzelne lokale Variablen pro Feld. Infrage kommt eine lokale
+    //Variable, die mit new T() deklariert wird, der nur new T() desselben Typs zugewiesen wird und die sonst nur für Feldzugriffe
+    //und Typtests benutzt wird. Jede andere Verwendung, also auch als Argument, Rückgabewert oder Empfänger eines Aufrufs, gilt
+    //als Entkommen. Das new wird dann zum Nullsetzen der Feldvariablen und der Typtest zur Konstante, der Heap bleibt unberührt.
+    //Das passt auf kurzlebige Hilfsobjekte in Schleifen, Stackallokation für Objekte, die an Aufrufe gehen, bräuchte eine Analyse
+    //über Funktionsgrenzen hinweg
+    class ScalarReplacement final {
+    public:
+        ScalarReplacement(const ParseInfo& info, Util::Arena& arena) : info(info), arena(arena) {
+        }
+
+        void run(FunctionBody* body) {
+            if (body == nullptr)
+                return;
+            candidates.assign(body->local_count, UNKNOWN);
+            declared.assign(body->local_count, false);
+            fields.clear();
+            find_candidates(body->block);
+            bool any = false;
+            for (uint32_t slot = 0; slot < body->local_count; ++slot) {
+                if (candidates[slot] >= 0 && !declared[slot])
+                    candidates[slot] = REJECTED;
+                any |= candidates[slot] >= 0;
+            }
+            if (!any)
+                return;
+            //neue Slots hinter den vorhandenen, einer pro benutztem Feld
+            std::vector<ValueType> local_types(body->local_types, body->local_types + body->local_count);
+            for (FieldSlot& field : fields) {
+                if (candidates[field.local] < 0)
+                    continue;
+                field.slot = static_cast<int>(local_types.size());
+                local_types.push_back(field.type);
+            }
+            ValueType* types = static_cast<ValueType*>(arena.allocate(sizeof(ValueType) * local_types.size(), alignof(ValueType)));
+            for (size_t i = 0; i < local_types.size(); ++i)
+                new (&types[i]) ValueType(local_types[i]);
+            body->local_types = types;
+            body->local_count = static_cast<uint32_t>(local_types.size());
+            for (uint32_t slot = 0; slot < candidates.size(); ++slot) {
+                if (candidates[slot] >= 0)
+                    Util::stats.add(Util::COUNTER_REPLACED_OBJECTS, 1);
+            }
+            rewrite_statement(body->block);
+        }
+
+    private:
+        static constexpr int UNKNOWN = -1;
+        static constexpr int REJECTED = -2;
+
+        struct FieldSlot {
+            int local;
+            int owner;
+            int index;
+            ValueType type;
+            int slot;
+        };
+
+        const ParseInfo& info;
+        Util::Arena& arena;
+        //Typ des new pro Slot, UNKNOWN oder REJECTED
+        std::vector<int> candidates;
+        std::vector<bool> declared;
+        std::vector<FieldSlot> fields;
+
+        static bool is_local(const Expr* expr) {
+            return expr != nullptr && expr->kind == ExprKind::LOCAL;
+        }
+
+        void reject(int slot) {
+            candidates[slot] = REJECTED;
+        }
+
+        void assign_new(int slot, const Expr* value) {
+            if (value == nullptr || value->kind != ExprKind::NEW || (candidates[slot] != UNKNOWN && candidates[slot] != value->index))
+                reject(slot);
+            else if (candidates[slot] == UNKNOWN)
+                candidates[slot] = value->index;
+        }
+
+        void use_field(const Expr* field) {
+            for (const FieldSlot& known : fields) {
+                if (known.local == field->left->index && known.owner == field->owner && known.index == field->index)
+                    return;
+            }
+            fields.push_back({field->left->index, field->owner, field->index, field->type, -1});
+        }
+
+        void find_candidates(const Stmt* stmt) {
+            if (stmt == nullptr)
+                return;
+            if (stmt->kind == StmtKind::VAR_DECL) {
+                assign_new(stmt->slot, stmt->value);
+                declared[stmt->slot] = true;
+            } else if (stmt->kind == StmtKind::ASSIGN) {
+                if (stmt->target->kind == ExprKind::LOCAL)
+                    assign_new(stmt->target->index, stmt->value);
+                else
+                    find_in_expression(stmt->target);
+            }
+            if (stmt->value != nullptr)
+                find_in_expression(stmt->value);
+            find_candidates(stmt->body);
+            find_candidates(stmt->otherwise);
+            for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                find_candidates(stmt->statements[i]);
+        }
+
+        void find_in_expression(const Expr* expr) {
+            if (expr->kind == ExprKind::LOCAL) {
+                reject(expr->index);
+                return;
+            }
+            if ((expr->kind == ExprKind::FIELD || expr->kind == ExprKind::IS_TYPE) && is_local(expr->left)) {
+                if (expr->kind == ExprKind::FIELD)
+                    use_field(expr);
+                return;
+            }
+            if (expr->left != nullptr)
+                find_in_expression(expr->left);
+            if (expr->right != nullptr)
+                find_in_expression(expr->right);
+            for (uint32_t i = 0; i < expr->arg_count; ++i)
+                find_in_expression(expr->args[i]);
+        }
+
+        //die neuen Feldslots liegen hinter candidates und werden nie ersetzt
+        bool is_replaced(const Expr* expr) const {
+            return is_local(expr) && static_cast<size_t>(expr->index) < candidates.size() && candidates[expr->index] >= 0;
+        }
+
+        //new T() wird zu einem Block, der die Feldvariablen auf den Nullwert setzt
+        void replace_allocation(Stmt* stmt, int local) {
+            std::vector<Stmt*> statements;
+            for (const FieldSlot& field : fields) {
+                if (field.local != local)
+                    continue;
+                Stmt* clear = arena.create<Stmt>();
+                clear->kind = StmtKind::VAR_DECL;
+                clear->slot = field.slot;
+                clear->offset = stmt->offset;
+                statements.push_back(clear);
+            }
+            stmt->kind = StmtKind::BLOCK;
+            stmt->target = nullptr;
+            stmt->value = nullptr;
+            stmt->slot = -1;
+            stmt->statement_count = static_cast<uint32_t>(statements.size());
+            stmt->statements = statements.empty() ? nullptr : static_cast<Stmt**>(arena.allocate(sizeof(Stmt*) * statements.size(), alignof(Stmt*)));
+            for (size_t i = 0; i < statements.size(); ++i)
+                stmt->statements[i] = statements[i];
+        }
+
+        void rewrite_statement(Stmt* stmt) {
+            if (stmt == nullptr)
+                return;
+            if (stmt->kind == StmtKind::VAR_DECL && candidates[stmt->slot] >= 0) {
+                replace_allocation(stmt, stmt->slot);
+                return;
+            }
+            if (stmt->kind == StmtKind::ASSIGN && is_replaced(stmt->target)) {
+                replace_allocation(stmt, stmt->target->index);
+                return;
+            }
+            if (stmt->target != nullptr)
+                rewrite_expression(stmt->target);
+            if (stmt->value != nullptr)
+                rewrite_expression(stmt->value);
+            rewrite_statement(stmt->body);
+            rewrite_statement(stmt->otherwise);
+            for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                rewrite_statement(stmt->statements[i]);
+        }
+
+        void rewrite_expression(Expr* expr) {
+            if (expr->left != nullptr)
+                rewrite_expression(expr->left);
+            if (expr->right != nullptr)
+                rewrite_expression(expr->right);
+            for (uint32_t i = 0; i < expr->arg_count; ++i)
+                rewrite_expression(expr->args[i]);
+            if (expr->kind == ExprKind::FIELD && is_replaced(expr->left)) {
+                for (const FieldSlot& field : fields) {
+                    if (field.local == expr->left->index && field.owner == expr->owner && field.index == expr->index) {
+                        expr->kind = ExprKind::LOCAL;
+                        expr->index = field.slot;
+                        break;
+                    }
+                }
+                expr->owner = -1;
+                expr->left = nullptr;
+            } else if (expr->kind == ExprKind::IS_TYPE && is_replaced(expr->left)) {
+                //der Typ steht fest und das Objekt ist nie null
+                expr->payload = is_subtype(info.types[candidates[expr->left->index]], info.types[expr->index]) ? 1 : 0;
+                expr->kind = ExprKind::BOOL_LITERAL;
+                expr->index = -1;
+                expr->left = nullptr;
+            }
+        }
+    };
+
+    //zerlegt die nicht entkommenden Objekte aller Rümpfe, parallel mit einer Arena pro Worker
+    void replace_scalars(Program& program, Util::WorkStealingPool& pool) {
+        ParseInfo& info = program.info;
+        pool.parallel_for(info.function_count, [&](size_t index) {
+            ScalarReplacement(info, *program.body_arenas[Util::WorkStealingPool::current_worker()]).run(info.functions[index].body);
+        });
+    }
+
+    //parst einen einzelnen Rumpf nach, wenn mit --decls-only kompiliert wurde. Nicht threadsicher
+    FunctionBody* ensure_function_body(Program& program, size_t function_index) {
+        FunctionInfo& function_info = program.info.functions[function_index];
+        if (function_info.body == nullptr && !function_info.is_linked && !function_info.is_intrinsic) {
+            if (program.body_arenas.empty())
+                program.body_arenas.emplace_back(new Util::Arena());
+            BodyParser body_parser(program.info, program.interner, *program.body_arenas[0], program.diagnostics);
+            function_info.body = body_parser.parse_function_body(function_info);
+            if (program.devirtualize)
+                devirtualize_statement(program, function_info.body->block);
+            if (program.fold_constants)
+                ConstantFolder(program).fold_body(function_info.body);
+            if (program.replace_scalars)
+                ScalarReplacement(program.info, *program.body_arenas[0]).run(function_info.body);
+        }
+        return function_info.body;
+    }
+
+    //Index der freien Funktion name oder -1
+    int find_function(const Program& program, const char* name) {
+        uint32_t id = program.interner.find(name);
+        uint32_t symbol = id == UINT32_MAX ? NO_SYMBOL : program.info.symbols->lookup_in_scope(SymbolTable::GLOBAL_SCOPE, id);
+        if (symbol == NO_SYMBOL || program.info.symbols->get(symbol).kind != SymbolKind::FUNCTION)
+            return -1;
+        return static_cast<int>(program.info.symbols->get(symbol).index);
+    }
+
+    //markiert, was von den Einstiegspunkten und den Initialisierern mit Nebenwirkungen aus erreichbar ist. Interpreter und
+    //C++ Backend übersetzen den Rest nicht. Eine Member Function ist erreichbar, sobald ein Aufruf ihren Slot benutzt und ihr
+    //Typ erreichbar ist, damit bleiben die Methodentabellen in beiden Backends vollständig. Im --decls-only Modus werden
+    //dabei nur die erreichbaren Rümpfe geparst
+    class DeadCodeElimination final {
+    public:
+        explicit DeadCodeElimination(Program& program) : program(program), info(program.info) {
+        }
+
+        void run(const std::vector<std::string>& entry_points) {
+            std::vector<int> roots;
+            for (const std::string& name : entry_points) {
+                int index = find_function(program, name.c_str());
+                if (index != -1)
+                    roots.push_back(index);
+            }
+            //ohne Einstiegspunkt, etwa bei einer Bibliothek, bleibt alles erhalten
+            if (roots.empty())
+                return;
+            program.live_functions.assign(info.function_count, false);
+            program.live_types.assign(info.type_count, false);
+            program.live_globals.assign(info.global_var_count, false);
+            find_slots();
+            for (int root : roots)
+                mark_function(root);
+            for (size_t i = 0; i < info.global_var_count; ++i) {
+                const Expr* initializer = ensure_global_initializer(program, i);
+                if (initializer != nullptr && !is_pure(initializer))
+                    mark_global(static_cast<int>(i));
+            }
+            while (!function_queue.empty() || !global_queue.empty()) {
+                if (!global_queue.empty()) {
+                    size_t index = global_queue.back();
+                    global_queue.pop_back();
+                    visit(info.global_vars[index].initializer_expr);
+                    continue;
+                }
+                size_t index = function_queue.back();
+                function_queue.pop_back();
+                if (FunctionBody* body = ensure_function_body(program, index))
+                    visit(body->block);
+            }
+            Util::stats.add(Util::COUNTER_DEAD_FUNCTIONS, std::count(program.live_functions.begin(), program.live_functions.end(), false));
+            Util::stats.add(Util::COUNTER_DEAD_TYPES, std::count(program.live_types.begin(), program.live_types.end(), false));
+            Util::stats.add(Util::COUNTER_DEAD_GLOBALS, std::count(program.live_globals.begin(), program.live_globals.end(), false));
+        }
+
+    private:
+        Program& program;
+        ParseInfo& info;
+        std::vector<size_t> function_queue;
+        std::vector<size_t> global_queue;
+        //je Member Function die Member Function, die ihren Slot eingeführt hat. called_slots und slot_members sind nach
+        //dieser indiziert
+        std::vector<int> introducers;
+        std::vector<bool> called_slots;
+        std::vector<std::vector<uint32_t>> slot_members;
+        std::vector<std::vector<uint32_t>> members;
+
+        void find_slots() {
+            introducers.assign(info.function_count, -1);
+            called_slots.assign(info.function_count, false);
+            slot_members.assign(info.function_count, {});
+            members.assign(info.type_count, {});
+            for (size_t i = 0; i < info.function_count; ++i) {
+                int type = info.functions[i].owner_type;
+                int slot = program.hierarchy.slot_of(i);
+                if (type == -1 || slot == -1)
+                    continue;
+                members[type].push_back(static_cast<uint32_t>(i));
+                while (info.types[type].super_type_index != -1 && program.hierarchy.method_table(info.types[type].super_type_index).size() > static_cast<size_t>(slot))
+                    type = info.types[type].super_type_index;
+                introducers[i] = static_cast<int>(program.hierarchy.method_table(type)[slot]);
+                slot_members[introducers[i]].push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        //ein negativer Index kommt nur aus Rümpfen mit Fehlern
+        void mark_function(int index) {
+            if (index < 0 || program.live_functions[index])
+                return;
+            program.live_functions[index] = true;
+            if (!info.functions[index].is_linked && !info.functions[index].is_intrinsic)
+                function_queue.push_back(index);
+        }
+
+        void mark_global(int index) {
+            if (index < 0 || program.live_globals[index])
+                return;
+            program.live_globals[index] = true;
+            if (info.global_vars[index].initializer_expr != nullptr)
+                global_queue.push_back(index);
+        }
+
+        //Supertypen gehören zum Layout und zu den Methodentabellen
+        void mark_type(int index) {
+            for (; index != -1 && !program.live_types[index]; index = info.types[index].super_type_index) {
+                program.live_types[index] = true;
+                for (uint32_t member : members[index]) {
+                    if (introducers[member] != -1 && called_slots[introducers[member]])
+                        mark_function(member);
+                }
+            }
+        }
+
+        void mark_slot(int function_index) {
+            int introducer = function_index < 0 ? -1 : introducers[function_index];
+            if (introducer == -1 || called_slots[introducer])
+                return;
+            called_slots[introducer] = true;
+            for (uint32_t member : slot_members[introducer]) {
+                if (program.live_types[info.functions[member].owner_type])
+                    mark_function(member);
+            }
+        }
+
+        //ein Initialisierer ohne Aufrufe und Feldzugriffe kann weder etwas verändern noch fehlschlagen
+        static bool is_pure(const Expr* expr) {
+            if (expr == nullptr)
+                return true;
+            switch (expr->kind) {
+                case ExprKind::CALL:
+                case ExprKind::METHOD_CALL:
+                case ExprKind::DIRECT_METHOD_CALL:
+                case ExprKind::FIELD:
+                    return false;
+                default:
+                    return is_pure(expr->left) && is_pure(expr->right);
+            }
+        }
+
+        void visit(const Expr* expr) {
+            if (expr == nullptr)
+                return;
+            //Zugriffe und Umwandlungen in Basistypen brauchen im C++ Backend die vollständige Definition des statischen Typs
+            if (expr->type.kind == ValueType::OBJECT)
+                mark_type(expr->type.type_index);
+            switch (expr->kind) {
+                case ExprKind::GLOBAL:
+                    mark_global(expr->index);
+                    break;
+                case ExprKind::FIELD:
+                    mark_type(expr->owner);
+                    break;
+                case ExprKind::CALL:
+                    mark_function(expr->index);
+                    break;
+                case ExprKind::METHOD_CALL:
+                case ExprKind::DIRECT_METHOD_CALL:
+                    if (expr->index >= 0)
+                        mark_type(info.functions[expr->index].owner_type);
+                    mark_slot(expr->index);
+                    break;
+                //IS_TYPE braucht nur die Typ IDs, die der Compiler für alle Typen übernimmt
+                case ExprKind::NEW:
+                    mark_type(expr->index);
+                    break;
+                default:
+                    break;
+            }
+            visit(expr->left);
+            visit(expr->right);
+            for (uint32_t i = 0; i < expr->arg_count; ++i)
+                visit(expr->args[i]);
+        }
+
+        void visit(const Stmt* stmt) {
+            if (stmt == nullptr)
+                return;
+            visit(stmt->target);
+            visit(stmt->value);
+            visit(stmt->body);
+            visit(stmt->otherwise);
+            for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                visit(stmt->statements[i]);
+        }
+    };
+
+    //Zähler, die sich erst am Ende aus dem Programm ablesen lassen
+    void collect_stats(const Program& program) {
+        Util::stats.add(Util::COUNTER_IDENTIFIERS, program.interner.size());
+        Util::stats.add(Util::COUNTER_TYPES, program.info.type_count);
+        Util::stats.add(Util::COUNTER_FUNCTIONS, program.info.function_count);
+        Util::stats.add(Util::COUNTER_GLOBALS, program.info.global_var_count);
+        auto add_arena = [](const Util::Arena& arena) {
+            Util::stats.add(Util::COUNTER_ARENA_BYTES, arena.bytes_used());
+            Util::stats.add(Util::COUNTER_ARENA_BLOCKS, arena.block_count());
+        };
+        add_arena(program.arena);
+        for (const std::unique_ptr<SourceFile>& file : program.files)
+            add_arena(file->arena);
+        for (const std::unique_ptr<Util::Arena>& arena : program.body_arenas)
+            add_arena(*arena);
+    }
+
+    size_t error_count(const Program& program) {
+        size_t errors = program.diagnostics.error_count();
+        for (const std::unique_ptr<SourceFile>& file : program.files)
+            errors += file->diagnostics.error_count();
+        return errors;
+    }
+
+    //tokenisiert und parst alle Dateien parallel und führt die Ergebnisse danach deterministisch zusammen
+    void compile_program(Program& program, const Options& options, Util::WorkStealingPool& pool) {
+        for (const std::string& path : options.inputs)
+            program.files.emplace_back(new SourceFile(path, static_cast<uint32_t>(program.files.size())));
+        pool.parallel_for(program.files.size(), [&](size_t index) {
+            compile_file(*program.files[index], options);
+        });
+        {
+            Util::PhaseTimer timer(Util::PHASE_MERGE);
+            program.info = merge_parse_infos(program);
+        }
+        {
+            Util::PhaseTimer timer(Util::PHASE_LAYOUT);
+            LayoutEngine(program).run();
+            program.hierarchy.build(program.info);
+        }
+        program.devirtualize = options.devirtualize;
+        program.replace_scalars = options.replace_scalars;
+        program.fold_constants = options.fold_constants;
+        if (options.decls_only && options.fold_constants) {
+            Util::PhaseTimer timer(Util::PHASE_FOLD);
+            ConstantFolder(program).run_declarations_only();
+        }
+        if (!options.decls_only) {
+            {
+                Util::PhaseTimer timer(Util::PHASE_BODIES);
+                parse_bodies(program, pool);
+            }
+            if (program.devirtualize) {
+                Util::PhaseTimer timer(Util::PHASE_DEVIRTUALIZE);
+                devirtualize(program, pool);
+            }
+            if (options.fold_constants) {
+                Util::PhaseTimer timer(Util::PHASE_FOLD);
+                ConstantFolder(program).run();
+            }
+            if (program.replace_scalars) {
+                Util::PhaseTimer timer(Util::PHASE_ESCAPE);
+                replace_scalars(program, pool);
+            }
+        }
+        if (options.eliminate_dead_code && error_count(program) == 0) {
+            Util::PhaseTimer timer(Util::PHASE_DEAD_CODE);
+            DeadCodeElimination(program).run(options.entry_points);
+        }
+        if (Util::stats.enabled)
+            collect_stats(program);
+    }
+
+    //gibt alle Meldungen aus, erst die der Dateien in Eingabereihenfolge, dann die des Programms. Liefert die Anzahl der Fehler
+    size_t report_diagnostics(const Program& program) {
+        std::vector<const Diagnostics::DiagnosticList*> lists;
+        std::vector<std::string> paths;
+        for (const std::unique_ptr<SourceFile>& file : program.files) {
+            lists.push_back(&file->diagnostics);
+            paths.push_back(file->path);
+        }
+        lists.push_back(&program.diagnostics);
+        Diagnostics::print(lists, paths);
+        return error_count(program);
+    }
+
+}
+
+//Bytecode und Interpreter. Jede Funktion wird in Registercode aus Befehlen fester Länge (8 Bytes) übersetzt. Die Register
+//einer Funktion beginnen mit den Slots aus FunctionBody (this, Parameter, lokale Variablen), dahinter liegen die Zwischenwerte.
+//Das Registerfenster eines Aufgerufenen beginnt bei seinem ersten Argument, Argumente werden also nie kopiert
+namespace VM {
+
+    using namespace Parsing;
+
+    struct TypeLayout;
+
+    enum StringFlags : uint32_t {
+        //die Zeichen enden mit einer Null und gehen ohne Kopie an linked Funktionen
+        STRING_TERMINATED = 1,
+        //Konstante aus dem Pool des Moduls, dort kommt jeder Inhalt nur einmal vor
+        STRING_POOLED = 2,
+        //Ausschnitt von slice, hinter dem Header steht statt der Zeichen ein Zeiger in die Zeichen des Ursprungs
+        STRING_SLICE = 4
+    };
+
+    //unveränderlich, die Zeichen liegen direkt hinter dem Header. nullptr ist die leere Zeichenkette
+    struct String {
+        uint32_t length;
+        uint32_t flags;
+
+        const char* chars() const {
+            if ((flags & STRING_SLICE) != 0)
+                return *reinterpret_cast<const char* const*>(this + 1);
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+
+    //Header und Zeichen in einer Allokation, die abschließende Null ist schon gesetzt
+    inline String* allocate_string(Util::Arena& arena, uint32_t length, uint32_t flags = STRING_TERMINATED) {
+        String* string = static_cast<String*>(arena.allocate(sizeof(String) + length + 1, alignof(String)));
+        string->length = length;
+        string->flags = flags;
+        const_cast<char*>(string->chars())[length] = '\0';
+        return string;
+    }
+
+    //Zeichenketten der Länge eins, damit slice für einzelne Zeichen nichts allokiert
+    inline String* single_character(char c) {
+        static struct Table {
+            struct Entry {
+                String header;
+                char chars[8];
+            } entries[256];
+
+            Table() {
+                for (int i = 0; i < 256; ++i) {
+                    entries[i].header = {1, STRING_TERMINATED};
+                    entries[i].chars[0] = static_cast<char>(i);
+                    entries[i].chars[1] = '\0';
+                }
+            }
+        } table;
+        return &table.entries[static_cast<unsigned char>(c)].header;
+    }
+
+    //Feld fester Länge für die intrinsic Funktionen. Die Zahlen liegen direkt hinter dem Header und sind dadurch auf
+    //32 Byte ausgerichtet. nullptr verhält sich wie ein leeres Feld
+    struct alignas(32) Numbers {
+        uint32_t length;
+
+        double* values() {
+            return reinterpret_cast<double*>(this + 1);
+        }
+    };
+
+    //die Felder liegen an den Offsets aus Driver::LayoutEngine, der Header zählt mit
+    struct Object {
+        const TypeLayout* type;
+    };
+    static_assert(sizeof(Object) == Driver::OBJECT_HEADER_SIZE, "Object header must match the layout engine");
+
+    //die Typen sind statisch bekannt, ein Wert braucht daher kein Tag. Booleans stehen immer als 0 oder 1 in bits
+    union Value {
+        double number;
+        uint64_t bits;
+        String* string;
+        Numbers* numbers;
+        Object* object;
+    };
+    static_assert(sizeof(Value) == 8, "Value should stay 8 bytes");
+
+    inline Value* field_at(Object* object, uint32_t offset) {
+        return reinterpret_cast<Value*>(reinterpret_cast<char*>(object) + offset);
+    }
+
+    //bool Felder belegen im Objekt nur ein Byte
+    inline uint8_t* bool_field_at(Object* object, uint32_t offset) {
+        return reinterpret_cast<uint8_t*>(object) + offset;
+    }
+
+    inline bool strings_equal(const String* a, const String* b) {
+        if (a == b)
+            return true;
+        //zwei verschiedene Konstanten aus dem Pool haben verschiedenen Inhalt
+        if (a != nullptr && b != nullptr && (a->flags & b->flags & STRING_POOLED) != 0)
+            return false;
+        uint32_t length = a == nullptr ? 0 : a->length;
+        if (length != (b == nullptr ? 0 : b->length))
+            return false;
+        return length == 0 || memcmp(a->chars(), b->chars(), length) == 0;
+    }
+
+    //a, b, c sind Register, Konstanten oder Sprungziele, je nach Befehl. wide() fasst b und c zu 32 Bit zusammen
+#define CORAL_OPCODES(X) \
+    X(MOVE) X(LOAD_CONST) X(LOAD_ZERO) X(LOAD_GLOBAL) X(STORE_GLOBAL) X(GET_FIELD) X(SET_FIELD) X(GET_BOOL_FIELD) X(SET_BOOL_FIELD) X(NEW) X(IS_TYPE) \
+    X(ADD) X(ADD_CONST) X(SUB) X(MUL) X(DIV) X(MOD) X(NEGATE) X(CONCAT) \
+    X(LESS) X(LESS_EQUAL) X(EQUAL_NUMBER) X(NOT_EQUAL_NUMBER) X(EQUAL_STRING) X(NOT_EQUAL_STRING) X(EQUAL_BITS) X(NOT_EQUAL_BITS) X(NOT) \
+    X(JUMP) X(JUMP_IF_TRUE) X(JUMP_IF_FALSE) X(JUMP_IF_LESS) X(JUMP_IF_NOT_LESS) X(JUMP_IF_LESS_EQUAL) X(JUMP_IF_NOT_LESS_EQUAL) \
+    X(CALL) X(CALL_DIRECT_METHOD) X(CALL_METHOD) X(CALL_NATIVE) X(TO_C_STRING) X(CALL_FOREIGN) X(RETURN) X(RETURN_VOID)
+
+    enum Op : uint8_t {
+#define CORAL_OPCODE_ENUM(name) OP_##name,
+        CORAL_OPCODES(CORAL_OPCODE_ENUM)
+#undef CORAL_OPCODE_ENUM
+        OP_COUNT
+    };
+
+    constexpr const char* OP_NAMES[] = {
+#define CORAL_OPCODE_NAME(name) #name,
+        CORAL_OPCODES(CORAL_OPCODE_NAME)
+#undef CORAL_OPCODE_NAME
+    };
+
+    struct Instruction {
+        Op op;
+        uint8_t unused;
+        uint16_t a, b, c;
+
+        uint32_t wide() const {
+            return b | (static_cast<uint32_t>(c) << 16);
+        }
+    };
+    static_assert(sizeof(Instruction) == 8, "Instruction should stay 8 bytes");
+
+    struct CompiledFunction {
+        std::string name;
+        std::vector<Instruction> code;
+        //Literale der Funktion, LOAD_CONST und ADD_CONST verweisen hierauf
+        std::vector<Value> constants;
+        uint32_t register_count = 0;
+    };
+
+    struct TypeLayout {
+        //Größe eines Objekts einschließlich Header
+        uint32_t size = 0;
+        //Intervall der Typ IDs aus Driver::ClassHierarchy, ein Subtyp liegt darin
+        uint32_t type_id = 0;
+        uint32_t last_subtype_id = 0;
+        //Member Functions nach Slot, überschriebene stehen im selben Slot wie im Supertyp
+        std::vector<const CompiledFunction*> vtable;
+    };
+
+    class Interpreter;
+
+    //Argumente ab arguments[0], das Ergebnis kommt nach arguments[0]. Liefert nullptr oder eine Fehlermeldung
+    typedef const char* (*NativeFunction)(Value* arguments, Interpreter& interpreter);
+
+    //Funktionen des Hosts für linked und intrinsic Deklarationen. parameters enthält je Parameter n, s, b oder a (numbers)
+    struct Native {
+        const char* name;
+        ValueType::Kind return_kind;
+        const char* parameters;
+        NativeFunction function;
+        //kann einen Laufzeitfehler melden, das C++ Backend übergibt dann den Namen der aufrufenden Funktion
+        bool can_fail = false;
+    };
+
+    //ruft symbol mit den Argumenten ab arguments[0] auf, das Ergebnis kommt nach arguments[0]
+    typedef void (*ForeignThunk)(void* symbol, Value* arguments, Interpreter& interpreter);
+
+    struct ForeignFunction {
+        void* symbol;
+        ForeignThunk thunk;
+    };
+
+    struct Module {
+        //gleicher Index wie in ParseInfo::functions, nullptr bei linked und intrinsic Funktionen
+        std::vector<std::unique_ptr<CompiledFunction>> functions;
+        std::vector<TypeLayout> types;
+        //Index in NATIVES für linked und intrinsic Funktionen, sonst -1
+        std::vector<int> native_indices;
+        //Index in foreign_functions für linked Funktionen ohne Native, sonst -1
+        std::vector<int> foreign_indices;
+        std::vector<ForeignFunction> foreign_functions;
+        //Handles von dlopen, werden vor dem Übersetzen gefüllt
+        std::vector<void*> libraries;
+        //Startwerte der globalen Variablen: gefaltete Konstanten, sonst Nullwerte
+        std::vector<Value> global_image;
+        //berechnet die übrigen globalen Variablen in Deklarationsreihenfolge
+        CompiledFunction initializer;
+        const CompiledFunction* main_function = nullptr;
+        //Speicher der String Konstanten
+        Util::Arena strings;
+    };
+
+    class Interpreter final {
+    public:
+        explicit Interpreter(const Module& module, size_t stack_size = 1 << 18, size_t max_depth = 1 << 15)
+            : module(module), stack(stack_size), frames(max_depth), globals(module.global_image) {
+        }
+
+        //führt die Initialisierung der globalen Variablen und danach main aus
+        bool run() {
+            Value result;
+            if (!call(module.initializer, nullptr, 0, result))
+                return false;
+            if (module.main_function == nullptr) {
+                error = "No function main() to run";
+                return false;
+            }
+            return call(*module.main_function, nullptr, 0, result);
+        }
+
+        bool call(const CompiledFunction& function, const Value* arguments, size_t argument_count, Value& result) {
+            if (function.register_count > stack.size()) {
+                error = "Stack overflow in " + function.name;
+                return false;
+            }
+            for (size_t i = 0; i < argument_count; ++i)
+                stack[i] = arguments[i];
+            if (!execute(&function, stack.data()))
+                return false;
+            result = stack[0];
+            return true;
+        }
+
+        String* make_string(const char* data, size_t length) {
+            if (length == 0)
+                return nullptr;
+            String* string = allocate_string(heap, static_cast<uint32_t>(length));
+            memcpy(const_cast<char*>(string->chars()), data, length);
+            return string;
+        }
+
+        //teilt sich die Zeichen mit string, start und length liegen innerhalb
+        String* slice(String* string, uint32_t start, uint32_t length) {
+            if (length == 0)
+                return nullptr;
+            if (length == string->length)
+                return string;
+            if (length == 1)
+                return single_character(string->chars()[start]);
+            String* slice = static_cast<String*>(heap.allocate(sizeof(String) + sizeof(const char*), alignof(const char*)));
+            slice->length = length;
+            slice->flags = STRING_SLICE | (start + length == string->length ? string->flags & STRING_TERMINATED : 0);
+            *reinterpret_cast<const char**>(slice + 1) = string->chars() + start;
+            return slice;
+        }
+
+        Numbers* make_numbers(uint32_t length) {
+            Numbers* numbers = static_cast<Numbers*>(heap.allocate(sizeof(Numbers) + length * sizeof(double), alignof(Numbers)));
+            numbers->length = length;
+            memset(static_cast<void*>(numbers->values()), 0, length * sizeof(double));
+            return numbers;
+        }
+
+        const std::string& get_error() const {
+            return error;
+        }
+
+    private:
+        struct Frame {
+            const Instruction* return_pc;
+            Value* base;
+            const CompiledFunction* function;
+        };
+
+        const Module& module;
+        std::vector<Value> stack;
+        std::vector<Frame> frames;
+        std::vector<Value> globals;
+        //Objekte und zur Laufzeit gebaute Strings. Es gibt noch keine Speicherbereinigung, alles lebt bis zum Ende
+        Util::Arena heap;
+        std::string error;
+
+        String* concat(const String* a, const String* b) {
+            if (a == nullptr)
+                return const_cast<String*>(b);
+            if (b == nullptr)
+                return const_cast<String*>(a);
+            String* string = allocate_string(heap, a->length + b->length);
+            memcpy(const_cast<char*>(string->chars()), a->chars(), a->length);
+            memcpy(const_cast<char*>(string->chars()) + a->length, b->chars(), b->length);
+            return string;
+        }
+
+        Object* allocate_object(const TypeLayout& layout) {
+            Object* object = static_cast<Object*>(heap.allocate(layout.size, alignof(Object)));
+            memset(static_cast<void*>(object), 0, layout.size);
+            object->type = &layout;
+            return object;
+        }
+
+        bool execute(const CompiledFunction* function, Value* base);
+    };
+
+    //Kernels der intrinsic Funktionen. Summen und Extremwerte laufen in acht festen Spuren, die am Ende immer in derselben
+    //Reihenfolge zusammengefasst werden, das Ergebnis hängt daher nicht davon ab, welcher Kernel gewählt wurde
+    constexpr size_t REDUCTION_LANES = 8;
+
+    inline double combine_sums(const double* lanes) {
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    inline double lesser(double value, double current) {
+        return value < current ? value : current;
+    }
+
+    inline double greater(double value, double current) {
+        return value > current ? value : current;
+    }
+
+    template<double (*Pick)(double, double)>
+    inline double combine_extremes(const double* lanes) {
+        double result = lanes[0];
+        for (size_t j = 1; j < REDUCTION_LANES; ++j)
+            result = Pick(lanes[j], result);
+        return result;
+    }
+
+    struct AddOp {
+        static double apply(double a, double b) { return a + b; }
+#ifdef CORAL_X86_KERNELS
+        __attribute__((target("sse2"))) static __m128d apply(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+        __attribute__((target("avx2"))) static __m256d apply(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+    };
+
+    struct SubOp {
+        static double apply(double a, double b) { return a - b; }
+#ifdef CORAL_X86_KERNELS
+        __attribute__((target("sse2"))) static __m128d apply(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+        __attribute__((target("avx2"))) static __m256d apply(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+#endif
+    };
+
+    struct MulOp {
+        static double apply(double a, double b) { return a * b; }
+#ifdef CORAL_X86_KERNELS
+        __attribute__((target("sse2"))) static __m128d apply(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+        __attribute__((target("avx2"))) static __m256d apply(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#endif
+    };
+
+    struct DivOp {
+        static double apply(double a, double b) { return a / b; }
+#ifdef CORAL_X86_KERNELS
+        __attribute__((target("sse2"))) static __m128d apply(__m128d a, __m128d b) { return _mm_div_pd(a, b); }
+        __attribute__((target("avx2"))) static __m256d apply(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+#endif
+    };
+
+    double sum_scalar(const double* a, size_t n) {
+        double lanes[REDUCTION_LANES] = {};
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            for (size_t j = 0; j < REDUCTION_LANES; ++j)
+                lanes[j] += a[i + j];
+        }
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i];
+        return total;
+    }
+
+    double dot_scalar(const double* a, const double* b, size_t n) {
+        double lanes[REDUCTION_LANES] = {};
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            for (size_t j = 0; j < REDUCTION_LANES; ++j)
+                lanes[j] += a[i + j] * b[i + j];
+        }
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i] * b[i];
+        return total;
+    }
+
+    //leer: +inf bei min, -inf bei max
+    template<double (*Pick)(double, double)>
+    double extreme_scalar(const double* a, size_t n) {
+        double lanes[REDUCTION_LANES];
+        std::fill(lanes, lanes + REDUCTION_LANES, Pick == lesser ? HUGE_VAL : -HUGE_VAL);
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            for (size_t j = 0; j < REDUCTION_LANES; ++j)
+                lanes[j] = Pick(a[i + j], lanes[j]);
+        }
+        double result = combine_extremes<Pick>(lanes);
+        for (; i < n; ++i)
+            result = Pick(a[i], result);
+        return result;
+    }
+
+    template<typename Op>
+    void elementwise_scalar(double* out, const double* a, const double* b, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = Op::apply(a[i], b[i]);
+    }
+
+    //std::fma rundet nur einmal, genau wie der AVX2 Befehl
+    void fma_scalar(double* out, const double* a, const double* b, const double* c, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = std::fma(a[i], b[i], c[i]);
+    }
+
+    void scale_scalar(double* out, const double* a, double factor, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = a[i] * factor;
+    }
+
+    void fill_scalar(double* out, double value, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = value;
+    }
+
+    size_t mismatch_scalar(const char* a, const char* b, size_t n) {
+        size_t i = 0;
+        while (i < n && a[i] == b[i])
+            ++i;
+        return i;
+    }
+
+    size_t find_scalar(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length) {
+        size_t position = std::string_view(haystack, haystack_length).find(std::string_view(needle, needle_length));
+        return position == std::string_view::npos ? SIZE_MAX : position;
+    }
+
+#ifdef CORAL_X86_KERNELS
+    __attribute__((target("sse2")))
+    double sum_sse2(const double* a, size_t n) {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            s0 = _mm_add_pd(s0, _mm_loadu_pd(a + i));
+            s1 = _mm_add_pd(s1, _mm_loadu_pd(a + i + 2));
+            s2 = _mm_add_pd(s2, _mm_loadu_pd(a + i + 4));
+            s3 = _mm_add_pd(s3, _mm_loadu_pd(a + i + 6));
+        }
+        double lanes[REDUCTION_LANES];
+        _mm_storeu_pd(lanes, s0);
+        _mm_storeu_pd(lanes + 2, s1);
+        _mm_storeu_pd(lanes + 4, s2);
+        _mm_storeu_pd(lanes + 6, s3);
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i];
+        return total;
+    }
+
+    __attribute__((target("sse2")))
+    double dot_sse2(const double* a, const double* b, size_t n) {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+            s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+            s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+        }
+        double lanes[REDUCTION_LANES];
+        _mm_storeu_pd(lanes, s0);
+        _mm_storeu_pd(lanes + 2, s1);
+        _mm_storeu_pd(lanes + 4, s2);
+        _mm_storeu_pd(lanes + 6, s3);
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i] * b[i];
+        return total;
+    }
+
+    //minpd und maxpd liefern wie lesser und greater den zweiten Operanden, wenn der Vergleich falsch ist
+    template<double (*Pick)(double, double)>
+    __attribute__((target("sse2")))
+    inline __m128d pick_sse2(__m128d value, __m128d current) {
+        return Pick == lesser ? _mm_min_pd(value, current) : _mm_max_pd(value, current);
+    }
+
+    template<double (*Pick)(double, double)>
+    __attribute__((target("sse2")))
+    double extreme_sse2(const double* a, size_t n) {
+        __m128d m0 = _mm_set1_pd(Pick == lesser ? HUGE_VAL : -HUGE_VAL), m1 = m0, m2 = m0, m3 = m0;
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            m0 = pick_sse2<Pick>(_mm_loadu_pd(a + i), m0);
+            m1 = pick_sse2<Pick>(_mm_loadu_pd(a + i + 2), m1);
+            m2 = pick_sse2<Pick>(_mm_loadu_pd(a + i + 4), m2);
+            m3 = pick_sse2<Pick>(_mm_loadu_pd(a + i + 6), m3);
+        }
+        double lanes[REDUCTION_LANES];
+        _mm_storeu_pd(lanes, m0);
+        _mm_storeu_pd(lanes + 2, m1);
+        _mm_storeu_pd(lanes + 4, m2);
+        _mm_storeu_pd(lanes + 6, m3);
+        double result = combine_extremes<Pick>(lanes);
+        for (; i < n; ++i)
+            result = Pick(a[i], result);
+        return result;
+    }
+
+    template<typename Op>
+    __attribute__((target("sse2")))
+    void elementwise_sse2(double* out, const double* a, const double* b, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(out + i, Op::apply(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        for (; i < n; ++i)
+            out[i] = Op::apply(a[i], b[i]);
+    }
+
+    __attribute__((target("sse2")))
+    void scale_sse2(double* out, const double* a, double factor, size_t n) {
+        __m128d multiplier = _mm_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), multiplier));
+        for (; i < n; ++i)
+            out[i] = a[i] * factor;
+    }
+
+    __attribute__((target("sse2")))
+    void fill_sse2(double* out, double value, size_t n) {
+        __m128d broadcast = _mm_set1_pd(value);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(out + i, broadcast);
+        for (; i < n; ++i)
+            out[i] = value;
+    }
+
+    __attribute__((target("sse2")))
+    size_t mismatch_sse2(const char* a, const char* b, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            unsigned mask = ~_mm_movemask_epi8(equal) & 0xFFFF;
+            if (mask != 0)
+                return i + __builtin_ctz(mask);
+        }
+        return i + mismatch_scalar(a + i, b + i, n - i);
+    }
+
+    //Kandidaten sind Stellen, an denen das erste und das letzte Zeichen von needle passen, nur diese werden verglichen
+    __attribute__((target("sse2")))
+    size_t find_sse2(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length) {
+        if (needle_length == 0 || needle_length > haystack_length)
+            return find_scalar(haystack, haystack_length, needle, needle_length);
+        __m128i first = _mm_set1_epi8(needle[0]);
+        __m128i last = _mm_set1_epi8(needle[needle_length - 1]);
+        size_t candidates = haystack_length - needle_length + 1;
+        size_t i = 0;
+        for (; i + 16 <= candidates; i += 16) {
+            __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+            __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needle_length - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+            while (mask != 0) {
+                size_t position = i + __builtin_ctz(mask);
+                if (memcmp(haystack + position, needle, needle_length) == 0)
+                    return position;
+                mask &= mask - 1;
+            }
+        }
+        size_t rest = find_scalar(haystack + i, haystack_length - i, needle, needle_length);
+        return rest == SIZE_MAX ? SIZE_MAX : i + rest;
+    }
+
+    __attribute__((target("avx2")))
+    double sum_avx2(const double* a, size_t n) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+            s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+        }
+        double lanes[REDUCTION_LANES];
+        _mm256_storeu_pd(lanes, s0);
+        _mm256_storeu_pd(lanes + 4, s1);
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i];
+        return total;
+    }
+
+    //ohne FMA, sonst wäre das Ergebnis anders gerundet als bei den anderen Kernels
+    __attribute__((target("avx2")))
+    double dot_avx2(const double* a, const double* b, size_t n) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+        }
+        double lanes[REDUCTION_LANES];
+        _mm256_storeu_pd(lanes, s0);
+        _mm256_storeu_pd(lanes + 4, s1);
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += a[i] * b[i];
+        return total;
+    }
+
+    template<double (*Pick)(double, double)>
+    __attribute__((target("avx2")))
+    inline __m256d pick_avx2(__m256d value, __m256d current) {
+        return Pick == lesser ? _mm256_min_pd(value, current) : _mm256_max_pd(value, current);
+    }
+
+    template<double (*Pick)(double, double)>
+    __attribute__((target("avx2")))
+    double extreme_avx2(const double* a, size_t n) {
+        __m256d m0 = _mm256_set1_pd(Pick == lesser ? HUGE_VAL : -HUGE_VAL), m1 = m0;
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+            m0 = pick_avx2<Pick>(_mm256_loadu_pd(a + i), m0);
+            m1 = pick_avx2<Pick>(_mm256_loadu_pd(a + i + 4), m1);
+        }
+        double lanes[REDUCTION_LANES];
+        _mm256_storeu_pd(lanes, m0);
+        _mm256_storeu_pd(lanes + 4, m1);
+        double result = combine_extremes<Pick>(lanes);
+        for (; i < n; ++i)
+            result = Pick(a[i], result);
+        return result;
+    }
+
+    template<typename Op>
+    __attribute__((target("avx2")))
+    void elementwise_avx2(double* out, const double* a, const double* b, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, Op::apply(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        for (; i < n; ++i)
+            out[i] = Op::apply(a[i], b[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void fma_avx2(double* out, const double* a, const double* b, const double* c, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i)));
+        for (; i < n; ++i)
+            out[i] = std::fma(a[i], b[i], c[i]);
+    }
+
+    __attribute__((target("avx2")))
+    void scale_avx2(double* out, const double* a, double factor, size_t n) {
+        __m256d multiplier = _mm256_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), multiplier));
+        for (; i < n; ++i)
+            out[i] = a[i] * factor;
+    }
+
+    __attribute__((target("avx2")))
+    void fill_avx2(double* out, double value, size_t n) {
+        __m256d broadcast = _mm256_set1_pd(value);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, broadcast);
+        for (; i < n; ++i)
+            out[i] = value;
+    }
+
+    __attribute__((target("avx2")))
+    size_t mismatch_avx2(const char* a, const char* b, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(equal));
+            if (mask != 0)
+                return i + __builtin_ctz(mask);
+        }
+        return i + mismatch_sse2(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t find_avx2(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length) {
+        if (needle_length == 0 || needle_length > haystack_length)
+            return find_scalar(haystack, haystack_length, needle, needle_length);
+        __m256i first = _mm256_set1_epi8(needle[0]);
+        __m256i last = _mm256_set1_epi8(needle[needle_length - 1]);
+        size_t candidates = haystack_length - needle_length + 1;
+        size_t i = 0;
+        for (; i + 32 <= candidates; i += 32) {
+            __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+            __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + needle_length - 1));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))));
+            while (mask != 0) {
+                size_t position = i + __builtin_ctz(mask);
+                if (memcmp(haystack + position, needle, needle_length) == 0)
+                    return position;
+                mask &= mask - 1;
+            }
+        }
+        size_t rest = find_sse2(haystack + i, haystack_length - i, needle, needle_length);
+        return rest == SIZE_MAX ? SIZE_MAX : i + rest;
+    }
+#endif
+
+    struct IntrinsicKernels {
+        const char* name;
+        double (*sum)(const double* a, size_t n);
+        double (*dot)(const double* a, const double* b, size_t n);
+        double (*min)(const double* a, size_t n);
+        double (*max)(const double* a, size_t n);
+        void (*add)(double* out, const double* a, const double* b, size_t n);
+        void (*sub)(double* out, const double* a, const double* b, size_t n);
+        void (*mul)(double* out, const double* a, const double* b, size_t n);
+        void (*div)(double* out, const double* a, const double* b, size_t n);
+        void (*fma)(double* out, const double* a, const double* b, const double* c, size_t n);
+        void (*scale)(double* out, const double* a, double factor, size_t n);
+        void (*fill)(double* out, double value, size_t n);
+        //Index des ersten unterschiedlichen Bytes, n wenn es keins gibt
+        size_t (*mismatch)(const char* a, const char* b, size_t n);
+        //Position von needle oder SIZE_MAX
+        size_t (*find)(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length);
+    };
+
+    IntrinsicKernels select_intrinsic_kernels() {
+        IntrinsicKernels kernels = {"scalar", sum_scalar, dot_scalar, extreme_scalar<lesser>, extreme_scalar<greater>,
+                                    elementwise_scalar<AddOp>, elementwise_scalar<SubOp>, elementwise_scalar<MulOp>, elementwise_scalar<DivOp>,
+                                    fma_scalar, scale_scalar, fill_scalar, mismatch_scalar, find_scalar};
+#ifdef CORAL_X86_KERNELS
+        Util::SimdLevel level = Util::select_simd_level();
+        if (level >= Util::SIMD_SSE2)
+            kernels = {"sse2", sum_sse2, dot_sse2, extreme_sse2<lesser>, extreme_sse2<greater>,
+                       elementwise_sse2<AddOp>, elementwise_sse2<SubOp>, elementwise_sse2<MulOp>, elementwise_sse2<DivOp>,
+                       fma_scalar, scale_sse2, fill_sse2, mismatch_sse2, find_sse2};
+        if (level >= Util::SIMD_AVX2)
+            kernels = {"avx2", sum_avx2, dot_avx2, extreme_avx2<lesser>, extreme_avx2<greater>,
+                       elementwise_avx2<AddOp>, elementwise_avx2<SubOp>, elementwise_avx2<MulOp>, elementwise_avx2<DivOp>,
+                       fma_avx2, scale_avx2, fill_avx2, mismatch_avx2, find_avx2};
+#endif
+        return kernels;
+    }
+
+    const IntrinsicKernels& intrinsic_kernels() {
+        static const IntrinsicKernels kernels = select_intrinsic_kernels();
+        return kernels;
+    }
+
+    const char* native_clock(Value* arguments, Interpreter&) {
+        arguments[0].number = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        return nullptr;
+    }
+
+    const char* native_print(Value* arguments, Interpreter&) {
+        const String* string = arguments[0].string;
+        if (string != nullptr)
+            fwrite(string->chars(), 1, string->length, stdout);
+        fputc('\n', stdout);
+        return nullptr;
+    }
+
+    const char* native_print_number(Value* arguments, Interpreter&) {
+        printf("%.17g\n", arguments[0].number);
+        return nullptr;
+    }
+
+    constexpr const char* LENGTH_MISMATCH = "Array lengths differ";
+
+    inline uint32_t string_length(const Value& value) {
+        return value.string == nullptr ? 0 : value.string->length;
+    }
+
+    inline uint32_t numbers_length(const Value& value) {
+        return value.numbers == nullptr ? 0 : value.numbers->length;
+    }
+
+    //bei einem leeren Feld wird der Zeiger nie gelesen
+    inline double* numbers_values(const Value& value) {
+        return value.numbers == nullptr ? nullptr : value.numbers->values();
+    }
+
+    const char* native_zeros(Value* arguments, Interpreter& interpreter) {
+        double length = arguments[0].number;
+        if (!(length >= 0 && length <= UINT32_MAX))
+            return "Invalid array length";
+        arguments[0].numbers = interpreter.make_numbers(static_cast<uint32_t>(length));
+        return nullptr;
+    }
+
+    const char* native_length(Value* arguments, Interpreter&) {
+        arguments[0].number = numbers_length(arguments[0]);
+        return nullptr;
+    }
+
+    const char* native_get(Value* arguments, Interpreter&) {
+        double index = arguments[1].number;
+        if (!(index >= 0 && index < numbers_length(arguments[0])))
+            return "Array index out of bounds";
+        arguments[0].number = arguments[0].numbers->values()[static_cast<uint32_t>(index)];
+        return nullptr;
+    }
+
+    const char* native_set(Value* arguments, Interpreter&) {
+        double index = arguments[1].number;
+        if (!(index >= 0 && index < numbers_length(arguments[0])))
+            return "Array index out of bounds";
+        arguments[0].numbers->values()[static_cast<uint32_t>(index)] = arguments[2].number;
+        return nullptr;
+    }
+
+    const char* native_sum(Value* arguments, Interpreter&) {
+        arguments[0].number = intrinsic_kernels().sum(numbers_values(arguments[0]), numbers_length(arguments[0]));
+        return nullptr;
+    }
+
+    const char* native_dot(Value* arguments, Interpreter&) {
+        uint32_t length = numbers_length(arguments[0]);
+        if (numbers_length(arguments[1]) != length)
+            return LENGTH_MISMATCH;
+        arguments[0].number = intrinsic_kernels().dot(numbers_values(arguments[0]), numbers_values(arguments[1]), length);
+        return nullptr;
+    }
+
+    const char* native_min(Value* arguments, Interpreter&) {
+        arguments[0].number = intrinsic_kernels().min(numbers_values(arguments[0]), numbers_length(arguments[0]));
+        return nullptr;
+    }
+
+    const char* native_max(Value* arguments, Interpreter&) {
+        arguments[0].number = intrinsic_kernels().max(numbers_values(arguments[0]), numbers_length(arguments[0]));
+        return nullptr;
+    }
+
+    //out darf einer der Operanden sein
+    template<void (* IntrinsicKernels::*Kernel)(double*, const double*, const double*, size_t)>
+    const char* native_elementwise(Value* arguments, Interpreter&) {
+        uint32_t length = numbers_length(arguments[0]);
+        if (numbers_length(arguments[1]) != length || numbers_length(arguments[2]) != length)
+            return LENGTH_MISMATCH;
+        (intrinsic_kernels().*Kernel)(numbers_values(arguments[0]), numbers_values(arguments[1]), numbers_values(arguments[2]), length);
+        return nullptr;
+    }
+
+    const char* native_fma(Value* arguments, Interpreter&) {
+        uint32_t length = numbers_length(arguments[0]);
+        if (numbers_length(arguments[1]) != length || numbers_length(arguments[2]) != length || numbers_length(arguments[3]) != length)
+            return LENGTH_MISMATCH;
+        intrinsic_kernels().fma(numbers_values(arguments[0]), numbers_values(arguments[1]), numbers_values(arguments[2]), numbers_values(arguments[3]), length);
+        return nullptr;
+    }
+
+    const char* native_scale(Value* arguments, Interpreter&) {
+        uint32_t length = numbers_length(arguments[0]);
+        if (numbers_length(arguments[1]) != length)
+            return LENGTH_MISMATCH;
+        intrinsic_kernels().scale(numbers_values(arguments[0]), numbers_values(arguments[1]), arguments[2].number, length);
+        return nullptr;
+    }
+
+    const char* native_fill(Value* arguments, Interpreter&) {
+        intrinsic_kernels().fill(numbers_values(arguments[0]), arguments[1].number, numbers_length(arguments[0]));
+        return nullptr;
+    }
+
+    //memmove ist in der C Bibliothek bereits für die CPU optimiert
+    const char* native_copy(Value* arguments, Interpreter&) {
+        uint32_t length = numbers_length(arguments[0]);
+        if (numbers_length(arguments[1]) != length)
+            return LENGTH_MISMATCH;
+        if (length != 0)
+            memmove(numbers_values(arguments[0]), numbers_values(arguments[1]), length * sizeof(double));
+        return nullptr;
+    }
+
+    //Position von arguments[1] in arguments[0] oder -1
+    const char* native_find(Value* arguments, Interpreter&) {
+        const String* haystack = arguments[0].string;
+        const String* needle = arguments[1].string;
+        size_t position = intrinsic_kernels().find(haystack == nullptr ? "" : haystack->chars(), haystack == nullptr ? 0 : haystack->length,
+                                                   needle == nullptr ? "" : needle->chars(), needle == nullptr ? 0 : needle->length);
+        arguments[0].number = position == SIZE_MAX ? -1.0 : static_cast<double>(position);
+        return nullptr;
+    }
+
+    //-1, 0 oder 1 im Vergleich der Bytes, ein Präfix ist kleiner
+    const char* native_compare(Value* arguments, Interpreter&) {
+        const String* a = arguments[0].string;
+        const String* b = arguments[1].string;
+        uint32_t a_length = a == nullptr ? 0 : a->length;
+        uint32_t b_length = b == nullptr ? 0 : b->length;
+        uint32_t common = std::min(a_length, b_length);
+        size_t at = common == 0 ? 0 : intrinsic_kernels().mismatch(a->chars(), b->chars(), common);
+        if (at < common)
+            arguments[0].number = static_cast<unsigned char>(a->chars()[at]) < static_cast<unsigned char>(b->chars()[at]) ? -1.0 : 1.0;
+        else
+            arguments[0].number = a_length < b_length ? -1.0 : (a_length > b_length ? 1.0 : 0.0);
+        return nullptr;
+    }
+
+    //der Ausschnitt ab arguments[1] mit Länge arguments[2], ohne die Zeichen zu kopieren
+    const char* native_slice(Value* arguments, Interpreter& interpreter) {
+        double start = arguments[1].number;
+        double length = arguments[2].number;
+        if (!(start >= 0 && length >= 0 && start + length <= string_length(arguments[0])))
+            return "Slice out of bounds";
+        arguments[0].string = interpreter.slice(arguments[0].string, static_cast<uint32_t>(start), static_cast<uint32_t>(length));
+        return nullptr;
+    }
+
+    const char* native_string_length(Value* arguments, Interpreter&) {
+        arguments[0].number = string_length(arguments[0]);
+        return nullptr;
+    }
+
+    const Native NATIVES[] = {
+        {"clock", ValueType::NUMBER, "", native_clock},
+        {"print", ValueType::VOID, "s", native_print},
+        {"print_number", ValueType::VOID, "n", native_print_number},
+        {"zeros", ValueType::NUMBERS, "n", native_zeros, true},
+        {"length", ValueType::NUMBER, "a", native_length},
+        {"get", ValueType::NUMBER, "an", native_get, true},
+        {"set", ValueType::VOID, "ann", native_set, true},
+        {"sum", ValueType::NUMBER, "a", native_sum},
+        {"dot", ValueType::NUMBER, "aa", native_dot, true},
+        {"min", ValueType::NUMBER, "a", native_min},
+        {"max", ValueType::NUMBER, "a", native_max},
+        {"add", ValueType::VOID, "aaa", native_elementwise<&IntrinsicKernels::add>, true},
+        {"sub", ValueType::VOID, "aaa", native_elementwise<&IntrinsicKernels::sub>, true},
+        {"mul", ValueType::VOID, "aaa", native_elementwise<&IntrinsicKernels::mul>, true},
+        {"div", ValueType::VOID, "aaa", native_elementwise<&IntrinsicKernels::div>, true},
+        {"fma", ValueType::VOID, "aaaa", native_fma, true},
+        {"scale", ValueType::VOID, "aan", native_scale, true},
+        {"fill", ValueType::VOID, "an", native_fill},
+        {"copy", ValueType::VOID, "aa", native_copy, true},
+        {"find", ValueType::NUMBER, "ss", native_find},
+        {"compare", ValueType::NUMBER, "ss", native_compare},
+        {"slice", ValueType::STRING, "snn", native_slice, true},
+        {"string_length", ValueType::NUMBER, "s", native_string_length}
+    };
+
+    //Index in NATIVES für eine linked oder intrinsic Funktion mit passender Signatur, sonst -1
+    int find_native(const FunctionInfo& function_info) {
+        for (size_t i = 0; i < sizeof(NATIVES) / sizeof(NATIVES[0]); ++i) {
+            const Native& native = NATIVES[i];
+            if (function_info.name != native.name || function_info.return_value_type.kind != native.return_kind
+                || function_info.param_count != strlen(native.parameters))
+                continue;
+            bool matches = true;
+            for (size_t j = 0; j < function_info.param_count; ++j) {
+                ValueType::Kind kind = function_info.param_value_types[j].kind;
+                char expected = native.parameters[j];
+                matches &= (expected == 'n' && kind == ValueType::NUMBER) || (expected == 's' && kind == ValueType::STRING) || (expected == 'b' && kind == ValueType::BOOL)
+                    || (expected == 'a' && kind == ValueType::NUMBERS);
+            }
+            if (matches)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    //linked Funktionen aus C Bibliotheken. Zahlen gehen als double, bool und Strings als Ganzzahl in Registerbreite,
+    //so dass je Signatur ein Thunk genügt, der beim Übersetzen ausgewählt wird
+    constexpr size_t MAX_FOREIGN_PARAMETERS = 4;
+
+    template<typename T>
+    inline T foreign_argument(const Value& value) {
+        if constexpr (std::is_same<T, double>::value)
+            return value.number;
+        else
+            return static_cast<T>(value.bits);
+    }
+
+    template<typename R, typename... A, size_t... I>
+    inline R invoke_foreign(void* symbol, const Value* arguments, std::index_sequence<I...>) {
+        return reinterpret_cast<R (*)(A...)>(symbol)(foreign_argument<A>(arguments[I])...);
+    }
+
+    inline void foreign_result(Value& result, double value, Interpreter&) {
+        result.number = value;
+    }
+
+    inline void foreign_result(Value& result, bool value, Interpreter&) {
+        result.bits = value;
+    }
+
+    //der zurückgegebene String gehört der Bibliothek und wird kopiert
+    inline void foreign_result(Value& result, const char* value, Interpreter& interpreter) {
+        result.string = value == nullptr ? nullptr : interpreter.make_string(value, strlen(value));
+    }
+
+    template<typename R, typename... A>
+    void foreign_thunk(void* symbol, Value* arguments, Interpreter& interpreter) {
+        if constexpr (std::is_void<R>::value)
+            invoke_foreign<R, A...>(symbol, arguments, std::index_sequence_for<A...>());
+        else
+            foreign_result(arguments[0], invoke_foreign<R, A...>(symbol, arguments, std::index_sequence_for<A...>()), interpreter);
+    }
+
+    //Bit i von integer_mask gesetzt: Parameter i wird als Ganzzahl übergeben
+    template<typename R, typename... A>
+    ForeignThunk select_foreign_thunk(uint32_t integer_mask, size_t parameter_count) {
+        if (sizeof...(A) == parameter_count)
+            return foreign_thunk<R, A...>;
+        if constexpr (sizeof...(A) < MAX_FOREIGN_PARAMETERS) {
+            if ((integer_mask >> sizeof...(A)) & 1)
+                return select_foreign_thunk<R, A..., uintptr_t>(integer_mask, parameter_count);
+            return select_foreign_thunk<R, A..., double>(integer_mask, parameter_count);
+        }
+        return nullptr;
+    }
+
+    //nullptr, wenn die Signatur Objekte enthält oder zu viele Parameter hat
+    ForeignThunk select_foreign_thunk(const FunctionInfo& function_info) {
+        if (function_info.param_count > MAX_FOREIGN_PARAMETERS)
+            return nullptr;
+        uint32_t integer_mask = 0;
+        for (size_t i = 0; i < function_info.param_count; ++i) {
+            ValueType::Kind kind = function_info.param_value_types[i].kind;
+            if (kind == ValueType::OBJECT || kind == ValueType::NUMBERS)
+                return nullptr;
+            if (kind != ValueType::NUMBER)
+                integer_mask |= 1u << i;
+        }
+        switch (function_info.return_value_type.kind) {
+            case ValueType::VOID: return select_foreign_thunk<void>(integer_mask, function_info.param_count);
+            case ValueType::NUMBER: return select_foreign_thunk<double>(integer_mask, function_info.param_count);
+            case ValueType::BOOL: return select_foreign_thunk<bool>(integer_mask, function_info.param_count);
+            case ValueType::STRING: return select_foreign_thunk<const char*>(integer_mask, function_info.param_count);
+            default: return nullptr;
+        }
+    }
+
+    //sucht das Symbol erst in den mit --link geladenen Bibliotheken, dann im Programm selbst
+    void* find_foreign_symbol(const std::vector<void*>& libraries, const std::string& name) {
+        for (void* library : libraries) {
+            if (void* symbol = dlsym(library, name.c_str()))
+                return symbol;
+        }
+        return dlsym(RTLD_DEFAULT, name.c_str());
+    }
+
+    //mit GCC und Clang springt jeder Befehl über eine Tabelle direkt zum nächsten, dadurch hat jeder Befehl seinen eigenen
+    //indirekten Sprung und der Branch Predictor kann Befehlsfolgen lernen. Sonst wird ein switch benutzt
+#if defined(__GNUC__) && !defined(CORAL_NO_COMPUTED_GOTO)
+#define CORAL_COMPUTED_GOTO 1
+#endif
+
+    bool Interpreter::execute(const CompiledFunction* function, Value* base) {
+        Frame* frame_base = frames.data();
+        Frame* frame_top = frame_base;
+        Frame* frame_end = frame_base + frames.size();
+        Value* stack_end = stack.data() + stack.size();
+        Value* global_values = globals.data();
+        const Value* constants = function->constants.data();
+        const Instruction* code = function->code.data();
+        const Instruction* pc = code;
+        const Instruction* instruction;
+        const CompiledFunction* callee;
+
+#ifdef CORAL_COMPUTED_GOTO
+        static const void* const LABELS[] = {
+#define CORAL_OPCODE_LABEL(name) &&LABEL_##name,
+            CORAL_OPCODES(CORAL_OPCODE_LABEL)
+#undef CORAL_OPCODE_LABEL
+        };
+#define CASE(name) LABEL_##name:
+#define DISPATCH() goto *LABELS[(instruction = pc++)->op]
+        DISPATCH();
+#else
+#define CASE(name) case OP_##name:
+#define DISPATCH() continue
+        while (true) {
+        dispatch_switch:
+            instruction = pc++;
+            switch (instruction->op) {
+#endif
+        CASE(MOVE)
+            base[instruction->a] = base[instruction->b];
+            DISPATCH();
+        CASE(LOAD_CONST)
+            base[instruction->a] = constants[instruction->wide()];
+            DISPATCH();
+        CASE(LOAD_ZERO)
+            base[instruction->a].bits = 0;
+            DISPATCH();
+        CASE(LOAD_GLOBAL)
+            base[instruction->a] = global_values[instruction->wide()];
+            DISPATCH();
+        CASE(STORE_GLOBAL)
+            global_values[instruction->wide()] = base[instruction->a];
+            DISPATCH();
+        CASE(GET_FIELD) {
+            Object* object = base[instruction->b].object;
+            if (object == nullptr)
+                goto null_reference;
+            base[instruction->a] = *field_at(object, instruction->c);
+            DISPATCH();
+        }
+        CASE(SET_FIELD) {
+            Object* object = base[instruction->a].object;
+            if (object == nullptr)
+                goto null_reference;
+            *field_at(object, instruction->b) = base[instruction->c];
+            DISPATCH();
+        }
+        CASE(GET_BOOL_FIELD) {
+            Object* object = base[instruction->b].object;
+            if (object == nullptr)
+                goto null_reference;
+            base[instruction->a].bits = *bool_field_at(object, instruction->c);
+            DISPATCH();
+        }
+        CASE(SET_BOOL_FIELD) {
+            Object* object = base[instruction->a].object;
+            if (object == nullptr)
+                goto null_reference;
+            *bool_field_at(object, instruction->b) = static_cast<uint8_t>(base[instruction->c].bits);
+            DISPATCH();
+        }
+        CASE(NEW)
+            base[instruction->a].object = allocate_object(module.types[instruction->wide()]);
+            DISPATCH();
+        //ein einziger vorzeichenloser Vergleich prüft beide Grenzen des Intervalls, null ist keine Instanz
+        CASE(IS_TYPE) {
+            const Object* object = base[instruction->b].object;
+            const TypeLayout& type = module.types[instruction->c];
+            base[instruction->a].bits = object != nullptr && object->type->type_id - type.type_id <= type.last_subtype_id - type.type_id;
+            DISPATCH();
+        }
+        CASE(ADD)
+            base[instruction->a].number = base[instruction->b].number + base[instruction->c].number;
+            DISPATCH();
+        CASE(ADD_CONST)
+            base[instruction->a].number = base[instruction->b].number + constants[instruction->c].number;
+            DISPATCH();
+        CASE(SUB)
+            base[instruction->a].number = base[instruction->b].number - base[instruction->c].number;
+            DISPATCH();
+        CASE(MUL)
+            base[instruction->a].number = base[instruction->b].number * base[instruction->c].number;
+            DISPATCH();
+        CASE(DIV)
+            base[instruction->a].number = base[instruction->b].number / base[instruction->c].number;
+            DISPATCH();
+        CASE(MOD)
+            base[instruction->a].number = fmod(base[instruction->b].number, base[instruction->c].number);
+            DISPATCH();
+        CASE(NEGATE)
+            base[instruction->a].number = -base[instruction->b].number;
+            DISPATCH();
+        CASE(CONCAT)
+            base[instruction->a].string = concat(base[instruction->b].string, base[instruction->c].string);
+            DISPATCH();
+        CASE(LESS)
+            base[instruction->a].bits = base[instruction->b].number < base[instruction->c].number;
+            DISPATCH();
+        CASE(LESS_EQUAL)
+            base[instruction->a].bits = base[instruction->b].number <= base[instruction->c].number;
+            DISPATCH();
+        CASE(EQUAL_NUMBER)
+            base[instruction->a].bits = base[instruction->b].number == base[instruction->c].number;
+            DISPATCH();
+        CASE(NOT_EQUAL_NUMBER)
+            base[instruction->a].bits = base[instruction->b].number != base[instruction->c].number;
+            DISPATCH();
+        CASE(EQUAL_STRING)
+            base[instruction->a].bits = strings_equal(base[instruction->b].string, base[instruction->c].string);
+            DISPATCH();
+        CASE(NOT_EQUAL_STRING)
+            base[instruction->a].bits = !strings_equal(base[instruction->b].string, base[instruction->c].string);
+            DISPATCH();
+        CASE(EQUAL_BITS)
+            base[instruction->a].bits = base[instruction->b].bits == base[instruction->c].bits;
+            DISPATCH();
+        CASE(NOT_EQUAL_BITS)
+            base[instruction->a].bits = base[instruction->b].bits != base[instruction->c].bits;
+            DISPATCH();
+        CASE(NOT)
+            base[instruction->a].bits = base[instruction->b].bits ^ 1;
+            DISPATCH();
+        CASE(JUMP)
+            pc = code + instruction->wide();
+            DISPATCH();
+        CASE(JUMP_IF_TRUE)
+            if (base[instruction->a].bits != 0)
+                pc = code + instruction->wide();
+            DISPATCH();
+        CASE(JUMP_IF_FALSE)
+            if (base[instruction->a].bits == 0)
+                pc = code + instruction->wide();
+            DISPATCH();
+        //Vergleich und Sprung in einem Befehl, das Ziel steht im folgenden JUMP
+        CASE(JUMP_IF_LESS)
+            pc = base[instruction->a].number < base[instruction->b].number ? code + pc->wide() : pc + 1;
+            DISPATCH();
+        CASE(JUMP_IF_NOT_LESS)
+            pc = !(base[instruction->a].number < base[instruction->b].number) ? code + pc->wide() : pc + 1;
+            DISPATCH();
+        CASE(JUMP_IF_LESS_EQUAL)
+            pc = base[instruction->a].number <= base[instruction->b].number ? code + pc->wide() : pc + 1;
+            DISPATCH();
+        CASE(JUMP_IF_NOT_LESS_EQUAL)
+            pc = !(base[instruction->a].number <= base[instruction->b].number) ? code + pc->wide() : pc + 1;
+            DISPATCH();
+        CASE(CALL)
+            callee = module.functions[instruction->wide()].get();
+            goto enter;
+        //Member Function mit nur einem möglichen Ziel: kein Umweg über die vtable, nur die Prüfung von this
+        CASE(CALL_DIRECT_METHOD)
+            if (base[instruction->a].object == nullptr)
+                goto null_reference;
+            callee = module.functions[instruction->wide()].get();
+            goto enter;
+        CASE(CALL_METHOD) {
+            Object* object = base[instruction->a].object;
+            if (object == nullptr)
+                goto null_reference;
+            callee = object->type->vtable[instruction->b];
+            goto enter;
+        }
+        CASE(CALL_NATIVE)
+            if (const char* message = NATIVES[instruction->wide()].function(base + instruction->a, *this)) {
+                error = std::string(message) + " in " + function->name;
+                return false;
+            }
+            DISPATCH();
+        CASE(TO_C_STRING) {
+            String* string = base[instruction->a].string;
+            //ein Ausschnitt mitten aus einer Zeichenkette hat keine abschließende Null
+            if (string != nullptr && (string->flags & STRING_TERMINATED) == 0)
+                string = make_string(string->chars(), string->length);
+            base[instruction->a].bits = reinterpret_cast<uintptr_t>(string != nullptr ? string->chars() : "");
+            DISPATCH();
+        }
+        CASE(CALL_FOREIGN) {
+            const ForeignFunction& foreign = module.foreign_functions[instruction->wide()];
+            foreign.thunk(foreign.symbol, base + instruction->a, *this);
+            DISPATCH();
+        }
+        CASE(RETURN)
+            base[0] = base[instruction->a];
+            goto leave;
+        CASE(RETURN_VOID)
+            goto leave;
+#ifndef CORAL_COMPUTED_GOTO
+            default:
+                break;
+            }
+            error = "Invalid instruction in " + function->name;
+            return false;
+        }
+#endif
+#undef CASE
+#undef DISPATCH
+
+    enter:
+        if (frame_top == frame_end || base + instruction->a + callee->register_count > stack_end) {
+            error = "Stack overflow in " + callee->name;
+            return false;
+        }
+        *frame_top++ = {pc, base, function};
+        base += instruction->a;
+        function = callee;
+        constants = callee->constants.data();
+        code = callee->code.data();
+        pc = code;
+#ifdef CORAL_COMPUTED_GOTO
+        goto *LABELS[(instruction = pc++)->op];
+#else
+        goto dispatch_switch;
+#endif
+
+    leave:
+        if (frame_top == frame_base)
+            return true;
+        --frame_top;
+        pc = frame_top->return_pc;
+        base = frame_top->base;
+        function = frame_top->function;
+        constants = function->constants.data();
+        code = function->code.data();
+#ifdef CORAL_COMPUTED_GOTO
+        goto *LABELS[(instruction = pc++)->op];
+#else
+        goto dispatch_switch;
+#endif
+
+    null_reference:
+        error = "Null reference in " + function->name;
+        return false;
+    }
+
+    //übersetzt die Rümpfe eines fehlerfreien Programms. Fehler, die erst hier auffallen, gehen nach program.diagnostics
+    class Compiler final {
+    public:
+        Compiler(Driver::Program& program, Module& module) : program(program), info(program.info), module(module) {
+        }
+
+        bool compile() {
+            size_t errors_before = program.diagnostics.error_count();
+            module.functions.resize(info.function_count);
+            module.native_indices.assign(info.function_count, -1);
+            module.foreign_indices.assign(info.function_count, -1);
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                bool is_native = function_info.is_linked || function_info.is_intrinsic;
+                if (function_info.owner_type != -1 && is_native)
+                    program.diagnostics.report(Diagnostics::Severity::ERROR, function_info.file, function_info.offset, "Member functions can not be linked or intrinsic");
+                //unerreichbare Funktionen bekommen weder Code noch ein aufgelöstes Symbol
+                if (!program.is_live_function(i))
+                    continue;
+                if (is_native) {
+                    module.native_indices[i] = find_native(function_info);
+                    if (module.native_indices[i] == -1 && function_info.is_linked && function_info.owner_type == -1)
+                        module.foreign_indices[i] = resolve_foreign(function_info);
+                } else {
+                    module.functions[i].reset(new CompiledFunction());
+                    module.functions[i]->name = function_info.owner_type == -1 ? function_info.name : info.types[function_info.owner_type].name + "." + function_info.name;
+                }
+            }
+            module.types.resize(info.type_count);
+            for (size_t i = 0; i < info.type_count; ++i) {
+                //is Tests prüfen auch gegen Typen, die nie angelegt werden und daher nicht erreichbar sind
+                module.types[i].type_id = info.types[i].type_id;
+                module.types[i].last_subtype_id = info.types[i].last_subtype_id;
+                if (program.is_live_type(i))
+                    compute_layout(static_cast<int>(i));
+            }
+
+            for (size_t i = 0; i < info.function_count; ++i) {
+                if (module.functions[i] == nullptr)
+                    continue;
+                const FunctionInfo& function_info = info.functions[i];
+                FunctionBody* body = Driver::ensure_function_body(program, i);
+                begin(*module.functions[i], function_info.file, body->local_count);
+                compile_statement(body->block);
+                if (function_info.return_value_type.kind == ValueType::VOID) {
+                    emit(OP_RETURN_VOID);
+                } else {
+                    //ein Rumpf, der ohne return endet, liefert den Nullwert
+                    uint32_t value = allocate();
+                    emit(OP_LOAD_ZERO, value);
+                    emit(OP_RETURN, value);
+                }
+                end();
+            }
+
+            //Literale kommen direkt ins Abbild. Eine zuweisbare Variable nur, solange vorher kein Code laufen konnte, der sie ändert
+            module.global_image.resize(info.global_var_count);
+            bool code_ran = false;
+            module.initializer.name = "<globals>";
+            begin(module.initializer, 0, 0);
+            for (size_t i = 0; i < info.global_var_count; ++i) {
+                if (!program.is_live_global(i))
+                    continue;
+                const GlobalVarInfo& global_info = info.global_vars[i];
+                const Expr* initializer = Driver::ensure_global_initializer(program, i);
+                if (initializer == nullptr)
+                    continue;
+                Value initial;
+                if ((global_info.is_constant || !code_ran) && image_value(initializer, initial)) {
+                    module.global_image[i] = initial;
+                    Util::stats.add(Util::COUNTER_IMAGE_GLOBALS, 1);
+                    continue;
+                }
+                code_ran = true;
+                file = global_info.file;
+                uint32_t value = compile_expression(initializer);
+                emit_wide(OP_STORE_GLOBAL, value, static_cast<uint32_t>(i));
+                next_register = 0;
+            }
+            emit(OP_RETURN_VOID);
+            end();
+
+            int main_index = Driver::find_function(program, "main");
+            if (main_index != -1 && info.functions[main_index].param_count == 0)
+                module.main_function = module.functions[main_index].get();
+            return program.diagnostics.error_count() == errors_before;
+        }
+
+    private:
+        Driver::Program& program;
+        const ParseInfo& info;
+        Module& module;
+        std::unordered_map<uint32_t, String*> string_constants;
+
+        //Zustand der gerade übersetzten Funktion
+        CompiledFunction* output = nullptr;
+        uint32_t file = 0;
+        uint32_t local_count = 0;
+        uint32_t next_register = 0;
+        uint32_t max_register = 0;
+        std::unordered_map<uint64_t, uint32_t> constant_indices;
+
+        //die vtable folgt der Methodentabelle aus Driver::ClassHierarchy
+        void compute_layout(int type_index) {
+            TypeLayout& layout = module.types[type_index];
+            for (uint32_t function_index : program.hierarchy.method_table(type_index))
+                layout.vtable.push_back(module.functions[function_index].get());
+            layout.size = info.types[type_index].size;
+            if (layout.size > UINT16_MAX)
+                program.diagnostics.report(Diagnostics::Severity::ERROR, info.types[type_index].file, info.types[type_index].offset, "Type " + info.types[type_index].name + " is too large");
+        }
+
+        void begin(CompiledFunction& function, uint32_t file, uint32_t local_count) {
+            output = &function;
+            this->file = file;
+            this->local_count = local_count;
+            next_register = max_register = local_count;
+            constant_indices.clear();
+        }
+
+        void end() {
+            if (max_register > UINT16_MAX)
+                program.diagnostics.report(Diagnostics::Severity::ERROR, file, 0, "Function " + output->name + " needs too many registers");
+            output->register_count = max_register;
+            Util::stats.add(Util::COUNTER_INSTRUCTIONS, output->code.size());
+        }
+
+        uint32_t allocate() {
+            uint32_t index = next_register++;
+            max_register = std::max(max_register, next_register);
+            return index;
+        }
+
+        size_t emit(Op op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+            output->code.push_back({op, 0, static_cast<uint16_t>(a), static_cast<uint16_t>(b), static_cast<uint16_t>(c)});
+            return output->code.size() - 1;
+        }
+
+        size_t emit_wide(Op op, uint32_t a, uint32_t value) {
+            return emit(op, a, value & 0xFFFF, value >> 16);
+        }
+
+        size_t here() const {
+            return output->code.size();
+        }
+
+        void patch(const std::vector<size_t>& jumps, size_t target) {
+            for (size_t jump : jumps) {
+                output->code[jump].b = static_cast<uint16_t>(target & 0xFFFF);
+                output->code[jump].c = static_cast<uint16_t>(target >> 16);
+            }
+        }
+
+        uint32_t add_constant(Value value) {
+            auto inserted = constant_indices.emplace(value.bits, static_cast<uint32_t>(output->constants.size()));
+            if (inserted.second)
+                output->constants.push_back(value);
+            return inserted.first->second;
+        }
+
+        //Wert eines Literals für das Abbild der globalen Variablen
+        bool image_value(const Expr* expr, Value& value) {
+            switch (expr->kind) {
+                case ExprKind::NUMBER_LITERAL:
+                    value.number = expr->number;
+                    return true;
+                case ExprKind::STRING_LITERAL:
+                    value.string = string_object(expr->payload);
+                    return true;
+                case ExprKind::BOOL_LITERAL:
+                    value.bits = expr->payload != 0;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        uint32_t number_constant(double number) {
+            Value value;
+            value.number = number;
+            return add_constant(value);
+        }
+
+        uint32_t string_constant(uint32_t payload) {
+            Value value;
+            value.string = string_object(payload);
+            return add_constant(value);
+        }
+
+        //Index in module.foreign_functions oder -1, wenn das Symbol fehlt oder die Signatur nicht über C aufrufbar ist
+        int resolve_foreign(const FunctionInfo& function_info) {
+            ForeignThunk thunk = select_foreign_thunk(function_info);
+            void* symbol = thunk == nullptr ? nullptr : find_foreign_symbol(module.libraries, function_info.name);
+            if (symbol == nullptr)
+                return -1;
+            module.foreign_functions.push_back({symbol, thunk});
+            return static_cast<int>(module.foreign_functions.size() - 1);
+        }
+
+        String* string_object(uint32_t payload) {
+            auto found = string_constants.find(payload);
+            if (found == string_constants.end()) {
+                std::string_view text = program.interner.get(payload);
+                String* string = nullptr;
+                if (!text.empty()) {
+                    string = allocate_string(module.strings, static_cast<uint32_t>(text.size()), STRING_TERMINATED | STRING_POOLED);
+                    memcpy(const_cast<char*>(string->chars()), text.data(), text.size());
+                }
+                found = string_constants.emplace(payload, string).first;
+            }
+            return found->second;
+        }
+
+        //das Feld, wenn der Rumpf nur aus return this.feld besteht, sonst nullptr
+        const Expr* inlinable_getter(int function_index) {
+            const FunctionBody* body = Driver::ensure_function_body(program, function_index);
+            if (body == nullptr || body->block->statement_count != 1)
+                return nullptr;
+            const Stmt* stmt = body->block->statements[0];
+            if (stmt->kind != StmtKind::RETURN || stmt->value == nullptr || stmt->value->kind != ExprKind::FIELD || stmt->value->left->kind != ExprKind::THIS)
+                return nullptr;
+            return stmt->value;
+        }
+
+        uint32_t field_offset(const Expr* field) {
+            return info.types[field->owner].fields[field->index].layout_offset;
+        }
+
+        //Anweisungen hinterlassen keine belegten Zwischenregister
+        void compile_statement(const Stmt* stmt) {
+            switch (stmt->kind) {
+                case StmtKind::BLOCK:
+                    for (uint32_t i = 0; i < stmt->statement_count; ++i)
+                        compile_statement(stmt->statements[i]);
+                    break;
+                case StmtKind::EXPR:
+                    compile_expression(stmt->value);
+                    break;
+                case StmtKind::VAR_DECL:
+                    if (stmt->value != nullptr)
+                        compile_expression(stmt->value, stmt->slot);
+                    else
+                        emit(OP_LOAD_ZERO, stmt->slot);
+                    break;
+                case StmtKind::ASSIGN: {
+                    const Expr* target = stmt->target;
+                    if (target->kind == ExprKind::LOCAL) {
+                        compile_expression(stmt->value, target->index);
+                    } else if (target->kind == ExprKind::GLOBAL) {
+                        emit_wide(OP_STORE_GLOBAL, compile_expression(stmt->value), static_cast<uint32_t>(target->index));
+                    } else {
+                        uint32_t object = compile_expression(target->left);
+                        uint32_t value = compile_expression(stmt->value);
+                        emit(target->type.kind == ValueType::BOOL ? OP_SET_BOOL_FIELD : OP_SET_FIELD, object, field_offset(target), value);
+                    }
+                    break;
+                }
+                case StmtKind::RETURN:
+                    if (stmt->value != nullptr)
+                        emit(OP_RETURN, compile_expression(stmt->value));
+                    else
+                        emit(OP_RETURN_VOID);
+                    break;
+                case StmtKind::IF: {
+                    std::vector<size_t> otherwise_jumps;
+                    compile_branch(stmt->value, false, otherwise_jumps);
+                    compile_statement(stmt->body);
+                    if (stmt->otherwise != nullptr) {
+                        size_t end_jump = emit(OP_JUMP);
+                        patch(otherwise_jumps, here());
+                        compile_statement(stmt->otherwise);
+                        patch({end_jump}, here());
+                    } else {
+                        patch(otherwise_jumps, here());
+                    }
+                    break;
+                }
+                case StmtKind::WHILE: {
+                    //Bedingung am Ende, damit jeder Durchlauf nur einen Sprung braucht
+                    size_t condition_jump = emit(OP_JUMP);
+                    size_t body_start = here();
+                    compile_statement(stmt->body);
+                    patch({condition_jump}, here());
+                    std::vector<size_t> body_jumps;
+                    compile_branch(stmt->value, true, body_jumps);
+                    patch(body_jumps, body_start);
+                    break;
+                }
+            }
+            next_register = local_count;
+        }
+
+        //springt zu jumps, wenn condition den Wert when hat. Vergleiche von Zahlen werden zu einem Befehl mit Sprung
+        void compile_branch(const Expr* condition, bool when, std::vector<size_t>& jumps) {
+            if (condition->kind == ExprKind::UNARY && condition->op == TokenType::BANG) {
+                compile_branch(condition->left, !when, jumps);
+                return;
+            }
+            if (condition->kind == ExprKind::BINARY) {
+                TokenType op = condition->op;
+                if ((op == TokenType::AND_AND && !when) || (op == TokenType::OR_OR && when)) {
+                    compile_branch(condition->left, when, jumps);
+                    compile_branch(condition->right, when, jumps);
+                    return;
+                }
+                if (op == TokenType::AND_AND || op == TokenType::OR_OR) {
+                    std::vector<size_t> skip_jumps;
+                    compile_branch(condition->left, !when, skip_jumps);
+                    compile_branch(condition->right, when, jumps);
+                    patch(skip_jumps, here());
+                    return;
+                }
+                if (op == TokenType::LESS || op == TokenType::GREATER || op == TokenType::LESS_EQUALS || op == TokenType::GREATER_EQUALS) {
+                    uint32_t mark = next_register;
+                    uint32_t left = compile_expression(condition->left);
+                    uint32_t right = compile_expression(condition->right);
+                    next_register = mark;
+                    //a > b ist b < a, auch für NaN
+                    bool swap = op == TokenType::GREATER || op == TokenType::GREATER_EQUALS;
+                    Op branch;
+                    if (op == TokenType::LESS_EQUALS || op == TokenType::GREATER_EQUALS)
+                        branch = when ? OP_JUMP_IF_LESS_EQUAL : OP_JUMP_IF_NOT_LESS_EQUAL;
+                    else
+                        branch = when ? OP_JUMP_IF_LESS : OP_JUMP_IF_NOT_LESS;
+                    emit(branch, swap ? right : left, swap ? left : right);
+                    jumps.push_back(emit(OP_JUMP));
+                    return;
+                }
+            }
+            uint32_t mark = next_register;
+            uint32_t value = compile_expression(condition);
+            next_register = mark;
+            jumps.push_back(emit(when ? OP_JUMP_IF_TRUE : OP_JUMP_IF_FALSE, value));
+        }
+
+        //das Ergebnis landet in target oder, wenn target -1 ist, in einem neuen Register (bei lokalen Variablen direkt in
+        //deren Slot). Alle anderen Zwischenregister sind danach wieder frei
+        uint32_t compile_expression(const Expr* expr, int target = -1) {
+            uint32_t mark = next_register;
+            switch (expr->kind) {
+                case ExprKind::NUMBER_LITERAL: {
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit_wide(OP_LOAD_CONST, result, number_constant(expr->number));
+                    return result;
+                }
+                case ExprKind::STRING_LITERAL: {
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit_wide(OP_LOAD_CONST, result, string_constant(expr->payload));
+                    return result;
+                }
+                case ExprKind::BOOL_LITERAL: {
+                    Value value;
+                    value.bits = expr->payload != 0;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit_wide(OP_LOAD_CONST, result, add_constant(value));
+                    return result;
+                }
+                case ExprKind::LOCAL:
+                case ExprKind::THIS: {
+                    uint32_t slot = expr->kind == ExprKind::THIS ? 0 : static_cast<uint32_t>(expr->index);
+                    if (target < 0 || static_cast<uint32_t>(target) == slot)
+                        return slot;
+                    emit(OP_MOVE, target, slot);
+                    return target;
+                }
+                case ExprKind::GLOBAL: {
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit_wide(OP_LOAD_GLOBAL, result, static_cast<uint32_t>(expr->index));
+                    return result;
+                }
+                case ExprKind::FIELD: {
+                    uint32_t object = compile_expression(expr->left);
+                    next_register = mark;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit(expr->type.kind == ValueType::BOOL ? OP_GET_BOOL_FIELD : OP_GET_FIELD, result, object, field_offset(expr));
+                    return result;
+                }
+                case ExprKind::NEW: {
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit_wide(OP_NEW, result, static_cast<uint32_t>(expr->index));
+                    return result;
+                }
+                case ExprKind::IS_TYPE: {
+                    uint32_t object = compile_expression(expr->left);
+                    next_register = mark;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    if (expr->index > UINT16_MAX)
+                        program.diagnostics.report(Diagnostics::Severity::ERROR, file, expr->offset, "Too many types for a type test");
+                    emit(OP_IS_TYPE, result, object, static_cast<uint32_t>(expr->index));
+                    return result;
+                }
+                case ExprKind::CALL:
+                case ExprKind::METHOD_CALL:
+                    return compile_call(expr, target);
+                case ExprKind::DIRECT_METHOD_CALL: {
+                    const Expr* field = inlinable_getter(expr->index);
+                    if (field == nullptr)
+                        return compile_call(expr, target);
+                    //Getter werden eingesetzt: GET_FIELD prüft this genauso wie der Aufruf
+                    uint32_t object = compile_expression(expr->left);
+                    next_register = mark;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit(field->type.kind == ValueType::BOOL ? OP_GET_BOOL_FIELD : OP_GET_FIELD, result, object, field_offset(field));
+                    Util::stats.add(Util::COUNTER_INLINED_CALLS, 1);
+                    return result;
+                }
+                case ExprKind::UNARY: {
+                    uint32_t operand = compile_expression(expr->left);
+                    next_register = mark;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit(expr->op == TokenType::BANG ? OP_NOT : OP_NEGATE, result, operand);
+                    return result;
+                }
+                case ExprKind::BINARY:
+                    return compile_binary(expr, target);
+            }
+            return 0;
+        }
+
+        //die Argumente werden direkt in das Registerfenster des Aufgerufenen geschrieben, bei Member Functions this zuerst
+        uint32_t compile_call(const Expr* call, int target) {
+            uint32_t base = next_register;
+            uint32_t first_argument = call->kind == ExprKind::METHOD_CALL || call->kind == ExprKind::DIRECT_METHOD_CALL ? 1 : 0;
+            for (uint32_t i = 0; i < std::max<uint32_t>(1, first_argument + call->arg_count); ++i)
+                allocate();
+            if (first_argument == 1)
+                compile_expression(call->left, base);
+            for (uint32_t i = 0; i < call->arg_count; ++i)
+                compile_expression(call->args[i], base + first_argument + i);
+            if (call->kind == ExprKind::METHOD_CALL) {
+                emit(OP_CALL_METHOD, base, static_cast<uint32_t>(program.hierarchy.slot_of(call->index)));
+            } else if (call->kind == ExprKind::DIRECT_METHOD_CALL) {
+                emit_wide(OP_CALL_DIRECT_METHOD, base, static_cast<uint32_t>(call->index));
+            } else if (module.functions[call->index] != nullptr) {
+                emit_wide(OP_CALL, base, static_cast<uint32_t>(call->index));
+            } else if (module.native_indices[call->index] != -1) {
+                emit_wide(OP_CALL_NATIVE, base, static_cast<uint32_t>(module.native_indices[call->index]));
+            } else if (module.foreign_indices[call->index] != -1) {
+                const FunctionInfo& callee = info.functions[call->index];
+                for (uint32_t i = 0; i < call->arg_count; ++i) {
+                    if (callee.param_value_types[i].kind == ValueType::STRING)
+                        emit(OP_TO_C_STRING, base + i);
+                }
+                emit_wide(OP_CALL_FOREIGN, base, static_cast<uint32_t>(module.foreign_indices[call->index]));
+            } else {
+                program.diagnostics.report(Diagnostics::Severity::ERROR, file, call->offset, "Function " + info.functions[call->index].name + " is not available in the interpreter");
+            }
+            next_register = base + 1;
+            if (target < 0)
+                return base;
+            emit(OP_MOVE, target, base);
+            next_register = base;
+            return target;
+        }
+
+        uint32_t compile_binary(const Expr* expr, int target) {
+            uint32_t mark = next_register;
+            TokenType op = expr->op;
+            if (op == TokenType::AND_AND || op == TokenType::OR_OR) {
+                //eine lokale Variable als Ziel könnte noch im rechten Operanden gelesen werden
+                uint32_t result = target >= static_cast<int>(local_count) ? target : allocate();
+                compile_expression(expr->left, result);
+                size_t jump = emit_wide(op == TokenType::AND_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE, result, 0);
+                compile_expression(expr->right, result);
+                patch({jump}, here());
+                if (target < 0 || static_cast<uint32_t>(target) == result)
+                    return result;
+                emit(OP_MOVE, target, result);
+                next_register = mark;
+                return target;
+            }
+            //x + k und x - k mit einem Literal brauchen kein Register für die Konstante
+            if ((op == TokenType::PLUS || op == TokenType::MINUS) && expr->type.kind == ValueType::NUMBER && expr->right->kind == ExprKind::NUMBER_LITERAL) {
+                Value value;
+                value.number = op == TokenType::MINUS ? -expr->right->number : expr->right->number;
+                uint32_t constant = add_constant(value);
+                if (constant <= UINT16_MAX) {
+                    uint32_t left = compile_expression(expr->left);
+                    next_register = mark;
+                    uint32_t result = target < 0 ? allocate() : target;
+                    emit(OP_ADD_CONST, result, left, constant);
+                    return result;
+                }
+            }
+            uint32_t left = compile_expression(expr->left);
+            uint32_t right = compile_expression(expr->right);
+            next_register = mark;
+            uint32_t result = target < 0 ? allocate() : target;
+            ValueType::Kind kind = expr->left->type.kind;
+            switch (op) {
+                case TokenType::PLUS:
+                    emit(kind == ValueType::STRING ? OP_CONCAT : OP_ADD, result, left, right);
+                    break;
+                case TokenType::MINUS:
+                    emit(OP_SUB, result, left, right);
+                    break;
+                case TokenType::STAR:
+                    emit(OP_MUL, result, left, right);
+                    break;
+                case TokenType::SLASH:
+                    emit(OP_DIV, result, left, right);
+                    break;
+                case TokenType::PERCENT:
+                    emit(OP_MOD, result, left, right);
+                    break;
+                case TokenType::LESS:
+                    emit(OP_LESS, result, left, right);
+                    break;
+                case TokenType::LESS_EQUALS:
+                    emit(OP_LESS_EQUAL, result, left, right);
+                    break;
+                case TokenType::GREATER:
+                    emit(OP_LESS, result, right, left);
+                    break;
+                case TokenType::GREATER_EQUALS:
+                    emit(OP_LESS_EQUAL, result, right, left);
+                    break;
+                case TokenType::EQUALS_EQUALS:
+                case TokenType::NOT_EQUALS: {
+                    bool equal = op == TokenType::EQUALS_EQUALS;
+                    if (kind == ValueType::NUMBER)
+                        emit(equal ? OP_EQUAL_NUMBER : OP_NOT_EQUAL_NUMBER, result, left, right);
+                    else if (kind == ValueType::STRING)
+                        emit(equal ? OP_EQUAL_STRING : OP_NOT_EQUAL_STRING, result, left, right);
+                    else
+                        emit(equal ? OP_EQUAL_BITS : OP_NOT_EQUAL_BITS, result, left, right);
+                    break;
+                }
+                default:
+                    break;
+            }
+            return result;
+        }
+    };
+
+    void disassemble(const CompiledFunction& function) {
+        Util::log(Util::TRACE, "function %s (%u registers, %zu constants)\n", function.name.c_str(), function.register_count, function.constants.size());
+        for (size_t i = 0; i < function.code.size(); ++i) {
+            const Instruction& instruction = function.code[i];
+            Util::log(Util::TRACE, "  %04zu %-24s %5u %5u %5u\n", i, OP_NAMES[instruction.op], instruction.a, instruction.b, instruction.c);
+        }
+    }
+
+}
+
+//übersetzt das Programm nach C++, damit Optimierer, LTO und PGO des Host Compilers greifen. Typen werden zu structs mit den
+//Feldern in der Reihenfolge ihres Layouts, Funktionen zu freien Funktionen oder Member Functions. Die Ausgabe hängt nur vom
+//Programm ab, nicht von Adressen oder Hashes, und lässt sich daher cachen
+namespace CppBackend {
+
+    using namespace Parsing;
+
+    //Laufzeit der erzeugten Programme mit denselben Werten und Natives wie der Interpreter
+    const char* const PRELUDE = R"(#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <initializer_list>
+#include <string_view>
+
+//linked functions get their own C++ name bound to the C symbol, so they can not clash with the declarations above
+#define CORAL_STRINGIFY_2(x) #x
+#define CORAL_STRINGIFY(x) CORAL_STRINGIFY_2(x)
+#define CORAL_LINKED(name) __asm__(CORAL_STRINGIFY(__USER_LABEL_PREFIX__) #name)
+
+namespace coral {
+
+    enum : uint32_t {
+        //chars ends with a NUL, so it can be passed to C functions as is
+        TERMINATED = 1,
+        //a literal from the read-only pool, which holds every content only once
+        POOLED = 2
+    };
+
+    //chars follows the header in the same allocation, only a slice points into the characters of another string
+    struct StringData {
+        uint32_t length;
+        uint32_t flags;
+        const char* chars;
+    };
+
+    //immutable, nullptr is the empty string
+    using string = const StringData*;
+
+    inline StringData* allocate_string(uint32_t length) {
+        StringData* s = static_cast<StringData*>(malloc(sizeof(StringData) + length + 1));
+        char* chars = reinterpret_cast<char*>(s + 1);
+        chars[length] = '\0';
+        return new (s) StringData{length, TERMINATED, chars};
+    }
+
+    //the vtable pointer is the 8 byte object header of the layout
+    struct Object {
+        virtual uint32_t coral_type_id() const = 0;
+    };
+
+    [[noreturn]] inline void fail(const char* message, const char* function) {
+        fflush(stdout);
+        fprintf(stderr, "runtime error: %s in %s\n", message, function);
+        exit(1);
+    }
+
+    [[noreturn]] inline void null_reference(const char* function) {
+        fail("Null reference", function);
+    }
+
+    template<typename T>
+    inline T* not_null(T* object, const char* function) {
+        if (object == nullptr)
+            null_reference(function);
+        return object;
+    }
+
+    inline string concat(string a, string b) {
+        if (a == nullptr)
+            return b;
+        if (b == nullptr)
+            return a;
+        StringData* s = allocate_string(a->length + b->length);
+        memcpy(const_cast<char*>(s->chars), a->chars, a->length);
+        memcpy(const_cast<char*>(s->chars) + a->length, b->chars, b->length);
+        return s;
+    }
+
+    //a slice from the middle of a string has no NUL and is copied
+    inline const char* c_str(string s) {
+        if (s == nullptr)
+            return "";
+        if ((s->flags & TERMINATED) == 0) {
+            StringData* copy = allocate_string(s->length);
+            memcpy(const_cast<char*>(copy->chars), s->chars, s->length);
+            return copy->chars;
+        }
+        return s->chars;
+    }
+
+    //a string returned by a linked function belongs to the library and is copied
+    inline string from_c(const char* chars) {
+        size_t length = chars != nullptr ? strlen(chars) : 0;
+        if (length == 0)
+            return nullptr;
+        StringData* s = allocate_string(static_cast<uint32_t>(length));
+        memcpy(const_cast<char*>(s->chars), chars, length);
+        return s;
+    }
+
+    inline bool equals(string a, string b) {
+        if (a == b)
+            return true;
+        if (a != nullptr && b != nullptr && (a->flags & b->flags & POOLED) != 0)
+            return false;
+        uint32_t length = a == nullptr ? 0 : a->length;
+        if (length != (b == nullptr ? 0 : b->length))
+            return false;
+        return length == 0 || memcmp(a->chars, b->chars, length) == 0;
+    }
+
+    //type IDs are numbered in pre-order, so every subtype lies in [first, last]
+    inline bool is_type(const Object* object, uint32_t first, uint32_t last) {
+        return object != nullptr && object->coral_type_id() - first <= last - first;
+    }
+
+    inline double native_clock() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void native_print(string s) {
+        if (s != nullptr)
+            fwrite(s->chars, 1, s->length, stdout);
+        fputc('\n', stdout);
+    }
+
+    inline void native_print_number(double n) {
+        printf("%.17g\n", n);
+    }
+
+    //fixed length array for the intrinsics, nullptr is an empty array
+    struct NumbersData {
+        uint32_t length;
+        double* values;
+    };
+
+    using numbers = NumbersData*;
+
+    inline uint32_t length_of(numbers a) {
+        return a == nullptr ? 0 : a->length;
+    }
+
+    inline double* values_of(numbers a) {
+        return a == nullptr ? nullptr : a->values;
+    }
+
+    inline void check_lengths(uint32_t length, std::initializer_list<numbers> others, const char* function) {
+        for (numbers other : others) {
+            if (length_of(other) != length)
+                fail("Array lengths differ", function);
+        }
+    }
+
+    inline numbers native_zeros(double length, const char* function) {
+        if (!(length >= 0 && length <= UINT32_MAX))
+            fail("Invalid array length", function);
+        uint32_t count = static_cast<uint32_t>(length);
+        return new NumbersData{count, static_cast<double*>(calloc(count == 0 ? 1 : count, sizeof(double)))};
+    }
+
+    inline double native_length(numbers a) {
+        return length_of(a);
+    }
+
+    inline double* element(numbers a, double index, const char* function) {
+        if (!(index >= 0 && index < length_of(a)))
+            fail("Array index out of bounds", function);
+        return a->values + static_cast<uint32_t>(index);
+    }
+
+    inline double native_get(numbers a, double index, const char* function) {
+        return *element(a, index, function);
+    }
+
+    inline void native_set(numbers a, double index, double value, const char* function) {
+        *element(a, index, function) = value;
+    }
+
+    //same eight lanes and the same final order as the interpreter, so the results are bit for bit identical
+    constexpr size_t LANES = 8;
+
+    inline double combine_sums(const double* lanes) {
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    inline double native_sum(numbers a) {
+        const double* values = values_of(a);
+        size_t n = length_of(a), i = 0;
+        double lanes[LANES] = {};
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t j = 0; j < LANES; ++j)
+                lanes[j] += values[i + j];
+        }
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += values[i];
+        return total;
+    }
+
+    inline double native_dot(numbers a, numbers b, const char* function) {
+        check_lengths(length_of(a), {b}, function);
+        const double* x = values_of(a);
+        const double* y = values_of(b);
+        size_t n = length_of(a), i = 0;
+        double lanes[LANES] = {};
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t j = 0; j < LANES; ++j)
+                lanes[j] += x[i + j] * y[i + j];
+        }
+        double total = combine_sums(lanes);
+        for (; i < n; ++i)
+            total += x[i] * y[i];
+        return total;
+    }
+
+    template<bool Min>
+    inline double extreme(numbers a) {
+        auto pick = [](double value, double current) { return (Min ? value < current : value > current) ? value : current; };
+        const double* values = values_of(a);
+        size_t n = length_of(a), i = 0;
+        double lanes[LANES];
+        for (double& lane : lanes)
+            lane = Min ? HUGE_VAL : -HUGE_VAL;
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t j = 0; j < LANES; ++j)
+                lanes[j] = pick(values[i + j], lanes[j]);
+        }
+        double result = lanes[0];
+        for (size_t j = 1; j < LANES; ++j)
+            result = pick(lanes[j], result);
+        for (; i < n; ++i)
+            result = pick(values[i], result);
+        return result;
+    }
+
+    inline double native_min(numbers a) {
+        return extreme<true>(a);
+    }
+
+    inline double native_max(numbers a) {
+        return extreme<false>(a);
+    }
+
+    template<typename Op>
+    inline void elementwise(numbers out, numbers a, numbers b, const char* function, Op op) {
+        uint32_t n = length_of(out);
+        check_lengths(n, {a, b}, function);
+        for (uint32_t i = 0; i < n; ++i)
+            out->values[i] = op(a->values[i], b->values[i]);
+    }
+
+    inline void native_add(numbers out, numbers a, numbers b, const char* function) {
+        elementwise(out, a, b, function, [](double x, double y) { return x + y; });
+    }
+
+    inline void native_sub(numbers out, numbers a, numbers b, const char* function) {
+        elementwise(out, a, b, function, [](double x, double y) { return x - y; });
+    }
+
+    inline void native_mul(numbers out, numbers a, numbers b, const char* function) {
+        elementwise(out, a, b, function, [](double x, double y) { return x * y; });
+    }
+
+    inline void native_div(numbers out, numbers a, numbers b, const char* function) {
+        elementwise(out, a, b, function, [](double x, double y) { return x / y; });
+    }
+
+    inline void native_fma(numbers out, numbers a, numbers b, numbers c, const char* function) {
+        uint32_t n = length_of(out);
+        check_lengths(n, {a, b, c}, function);
+        for (uint32_t i = 0; i < n; ++i)
+            out->values[i] = std::fma(a->values[i], b->values[i], c->values[i]);
+    }
+
+    inline void native_scale(numbers out, numbers a, double factor, const char* function) {
+        uint32_t n = length_of(out);
+        check_lengths(n, {a}, function);
+        for (uint32_t i = 0; i < n; ++i)
+            out->values[i] = a->values[i] * factor;
+    }
+
+    inline void native_fill(numbers a, double value) {
+        for (uint32_t i = 0; i < length_of(a); ++i)
+            a->values[i] = value;
+    }
+
+    inline void native_copy(numbers destination, numbers source, const char* function) {
+        check_lengths(length_of(destination), {source}, function);
+        if (length_of(destination) != 0)
+            memmove(destination->values, source->values, length_of(destination) * sizeof(double));
+    }
+
+    inline std::string_view view(string s) {
+        return s == nullptr ? std::string_view() : std::string_view(s->chars, s->length);
+    }
+
+    inline double native_find(string haystack, string needle) {
+        size_t position = view(haystack).find(view(needle));
+        return position == std::string_view::npos ? -1.0 : static_cast<double>(position);
+    }
+
+    inline double native_compare(string a, string b) {
+        int result = view(a).compare(view(b));
+        return result < 0 ? -1.0 : (result > 0 ? 1.0 : 0.0);
+    }
+
+    //strings of length one, so slicing out a single character allocates nothing
+    inline string single_character(char c) {
+        static struct Table {
+            StringData strings[256];
+            char chars[512];
+
+            Table() {
+                for (int i = 0; i < 256; ++i) {
+                    chars[2 * i] = static_cast<char>(i);
+                    chars[2 * i + 1] = '\0';
+                    strings[i] = {1, TERMINATED, &chars[2 * i]};
+                }
+            }
+        } table;
+        return &table.strings[static_cast<unsigned char>(c)];
+    }
+
+    //shares the characters of s instead of copying them
+    inline string native_slice(string s, double start, double length, const char* function) {
+        uint32_t total = s == nullptr ? 0 : s->length;
+        if (!(start >= 0 && length >= 0 && start + length <= total))
+            fail("Slice out of bounds", function);
+        uint32_t first = static_cast<uint32_t>(start);
+        uint32_t count = static_cast<uint32_t>(length);
+        if (count == 0)
+            return nullptr;
+        if (count == total)
+            return s;
+        if (count == 1)
+            return single_character(s->chars[first]);
+        return new StringData{count, first + count == total ? s->flags & TERMINATED : 0, s->chars + first};
+    }
+
+    inline double native_string_length(string s) {
+        return s == nullptr ? 0 : s->length;
+    }
+
+}
+)";
+
+    class Emitter final {
+    public:
+        explicit Emitter(const Driver::Program& program) : program(program), info(program.info) {
+        }
+
+        std::string emit() {
+            std::vector<int> type_order(info.type_count);
+            for (size_t i = 0; i < info.type_count; ++i)
+                type_order[info.types[i].type_id] = static_cast<int>(i);
+
+            //unerreichbare Typen können noch in Signaturen und Feldern vorkommen, deshalb bekommen alle eine Vorwärtsdeklaration
+            std::string declarations;
+            for (int type_index : type_order)
+                declarations += "struct " + type_name(type_index) + ";\n";
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                if (is_foreign(i) && program.is_live_function(i))
+                    declarations += "extern \"C\" " + signature(function_info, function_name(i), true) + " CORAL_LINKED(" + function_info.name + ");\n";
+            }
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                if (function_info.owner_type == -1 && !function_info.is_linked && !function_info.is_intrinsic && program.is_live_function(i))
+                    declarations += signature(function_info, function_name(i)) + ";\n";
+            }
+
+            std::string types;
+            for (int type_index : type_order) {
+                if (program.is_live_type(type_index))
+                    emit_type(type_index, types);
+            }
+
+            std::string globals = emit_globals();
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                if (!function_info.is_linked && !function_info.is_intrinsic && program.is_live_function(i))
+                    emit_function(i);
+            }
+
+            std::string output = "//generated by coralc --emit-cpp\n";
+            output += PRELUDE;
+            output += "\n" + declarations + "\n" + literals + "\n" + types + globals + "\n" + code;
+            int main_index = Driver::find_function(program, "main");
+            if (main_index != -1 && info.functions[main_index].param_count == 0)
+                output += "\nint main() {\n    coral_init_globals();\n    " + function_name(main_index) + "();\n    return 0;\n}\n";
+            return output;
+        }
+
+    private:
+        const Driver::Program& program;
+        const ParseInfo& info;
+        //String Konstanten nach Reihenfolge der ersten Verwendung
+        std::string literals;
+        std::unordered_map<uint32_t, std::string> literal_names;
+        std::string code;
+
+        //Zustand der gerade übersetzten Funktion
+        std::string function_display_name;
+        const FunctionBody* body = nullptr;
+        int this_type = -1;
+        uint32_t temp_count = 0;
+        int indent = 0;
+
+        //die Präfixe verhindern Kollisionen mit Schlüsselwörtern und Namen aus C++
+        std::string type_name(int type_index) const {
+            return "T_" + info.types[type_index].name;
+        }
+
+        std::string function_name(size_t function_index) const {
+            const FunctionInfo& function_info = info.functions[function_index];
+            if (function_info.owner_type != -1)
+                return "m_" + function_info.name;
+            if (function_info.is_linked || function_info.is_intrinsic) {
+                int native = VM::find_native(function_info);
+                return native != -1 ? std::string("coral::native_") + VM::NATIVES[native].name : "linked_" + function_info.name;
+            }
+            return "fn_" + function_info.name;
+        }
+
+        static std::string local_name(uint32_t slot) {
+            return "l" + std::to_string(slot);
+        }
+
+        std::string abi_type(const ValueType& type, bool c_abi) const {
+            return c_abi && type.kind == ValueType::STRING ? "const char*" : cpp_type(type);
+        }
+
+        //linked Funktionen aus C Bibliotheken, nicht die eingebauten aus VM::NATIVES
+        bool is_foreign(size_t function_index) const {
+            const FunctionInfo& function_info = info.functions[function_index];
+            return function_info.owner_type == -1 && (function_info.is_linked || function_info.is_intrinsic) && VM::find_native(function_info) == -1;
+        }
+
+        std::string cpp_type(const ValueType& type) const {
+            switch (type.kind) {
+                case ValueType::NUMBER: return "double";
+                case ValueType::STRING: return "coral::string";
+                case ValueType::BOOL: return "bool";
+                case ValueType::NUMBERS: return "coral::numbers";
+                case ValueType::OBJECT: return type_name(type.type_index) + "*";
+                default: return "void";
+            }
+        }
+
+        std::string zero_value(const ValueType& type) const {
+            switch (type.kind) {
+                case ValueType::NUMBER: return "0.0";
+                case ValueType::BOOL: return "false";
+                default: return "nullptr";
+            }
+        }
+
+        //bei Member Functions ist Slot 0 this, die Parameter folgen. Über die C ABI gehen Strings als const char*
+        std::string signature(const FunctionInfo& function_info, const std::string& name, bool c_abi = false) const {
+            std::string text = abi_type(function_info.return_value_type, c_abi) + " " + name + "(";
+            uint32_t first_slot = function_info.owner_type == -1 ? 0 : 1;
+            for (size_t i = 0; i < function_info.param_count; ++i) {
+                if (i > 0)
+                    text += ", ";
+                text += abi_type(function_info.param_value_types[i], c_abi) + " " + local_name(first_slot + static_cast<uint32_t>(i));
+            }
+            return text + ")";
+        }
+
+        static std::string number_literal(double value) {
+            //das Vorzeichen bleibt erhalten, der Interpreter gibt es als -nan aus
+            if (std::isnan(value))
+                return std::signbit(value) ? "(-std::numeric_limits<double>::quiet_NaN())" : "std::numeric_limits<double>::quiet_NaN()";
+            if (std::isinf(value))
+                return value > 0 ? "std::numeric_limits<double>::infinity()" : "(-std::numeric_limits<double>::infinity())";
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+            std::string text = buffer;
+            if (text.find_first_of(".e") == std::string::npos)
+                text += ".0";
+            return value < 0 || (value == 0 && std::signbit(value)) ? "(" + text + ")" : text;
+        }
+
+        std::string string_literal(uint32_t payload) {
+            std::string_view text = program.interner.get(payload);
+            if (text.empty())
+                return "coral::string(nullptr)";
+            auto found = literal_names.find(payload);
+            if (found != literal_names.end())
+                return found->second;
+            std::string name = "&s" + std::to_string(literal_names.size());
+            //oktale Escapes haben höchstens drei Ziffern und können daher nicht mit folgenden Zeichen verschmelzen
+            std::string escaped;
+            for (char c : text) {
+                unsigned char byte = static_cast<unsigned char>(c);
+                if (byte < 0x20 || byte >= 0x7F || c == '"' || c == '\\' || c == '?') {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\%03o", byte);
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+            }
+            literals += "static const coral::StringData " + name.substr(1) + " = {" + std::to_string(text.size()) + ", coral::TERMINATED | coral::POOLED, \"" + escaped + "\"};\n";
+            literal_names.emplace(payload, name);
+            return name;
+        }
+
+        //Member Functions, die nirgends überschrieben werden, bleiben nicht virtuell und werden direkt aufgerufen
+        void emit_type(int type_index, std::string& output) {
+            const TypeInfo& type_info = info.types[type_index];
+            bool is_leaf = program.hierarchy.direct_subtypes(type_index).empty();
+            output += "struct " + type_name(type_index) + (is_leaf ? " final" : "") + " : "
+                + (type_info.super_type_index == -1 ? std::string("coral::Object") : type_name(type_info.super_type_index)) + " {\n";
+            std::vector<const FieldInfo*> fields;
+            for (size_t i = 0; i < type_info.field_count; ++i)
+                fields.push_back(&type_info.fields[i]);
+            std::sort(fields.begin(), fields.end(), [](const FieldInfo* a, const FieldInfo* b) {
+                return a->layout_offset < b->layout_offset;
+            });
+            for (const FieldInfo* field : fields)
+                output += "    " + cpp_type(field->value_type) + " f_" + field->name + "; //offset " + std::to_string(field->layout_offset) + "\n";
+            output += "    uint32_t coral_type_id() const override {\n        return " + std::to_string(type_info.type_id) + ";\n    }\n";
+            size_t inherited_slots = type_info.super_type_index == -1 ? 0 : program.hierarchy.method_table(type_info.super_type_index).size();
+            for (size_t i = 0; i < info.function_count; ++i) {
+                const FunctionInfo& function_info = info.functions[i];
+                if (function_info.owner_type != type_index || function_info.is_linked || function_info.is_intrinsic || !program.is_live_function(i))
+                    continue;
+                bool overrides = static_cast<size_t>(program.hierarchy.slot_of(i)) < inherited_slots;
+                bool is_virtual = !overrides && program.hierarchy.single_target(type_index, i) == -1;
+                output += std::string("    ") + (is_virtual ? "virtual " : "") + signature(function_info, function_name(i)) + (overrides ? " override" : "") + ";\n";
+            }
+            output += "};\n\n";
+        }
+
+        std::string emit_globals() {
+            std::string output;
+            //wie beim Interpreter: Literale stehen schon im Abbild, eine zuweisbare Variable nur, solange vorher kein Code lief
+            bool code_ran = false;
+            function_display_name = "<globals>";
+            this_type = -1;
+            temp_count = 0;
+            indent = 1;
+            code += "static void coral_init_globals() {\n";
+            for (size_t i = 0; i < info.global_var_count; ++i) {
+                const GlobalVarInfo& global_info = info.global_vars[i];
+                if (!program.is_live_global(i))
+                    continue;
+                std::string initial = zero_value(global_info.value_type);
+                const Expr* initializer = global_info.initializer_expr;
+                if (initializer != nullptr && (global_info.is_constant || !code_ran) && is_literal(initializer)) {
+                    initial = expression(initializer);
+                } else if (initializer != nullptr) {
+                    code_ran = true;
+                    std::string value = expression(initializer);
+                    line("g_" + global_info.name + " = " + value + ";");
+                }
+                output += "static " + cpp_type(global_info.value_type) + " g_" + global_info.name + " = " + initial + ";\n";
+            }
+            code += "}\n";
+            return output;
+        }
+
+        void emit_function(size_t function_index) {
+            const FunctionInfo& function_info = info.functions[function_index];
+            body = function_info.body;
+            this_type = function_info.owner_type;
+            function_display_name = this_type == -1 ? function_info.name : info.types[this_type].name + "." + function_info.name;
+            temp_count = 0;
+            indent = 1;
+            code += "\n" + signature(function_info, this_type == -1 ? function_name(function_index) : type_name(this_type) + "::" + function_name(function_index)) + " {\n";
+            //lokale Variablen haben eigene Slots und werden vorab mit dem Nullwert angelegt
+            uint32_t first_local = static_cast<uint32_t>(function_info.param_count) + (this_type == -1 ? 0 : 1);
+            for (uint32_t slot = first_local; slot < body->local_count; ++slot)
+                line(cpp_type(body->local_types[slot]) + " " + local_name(slot) + " = " + zero_value(body->local_types[slot]) + ";");
+            statements(body->block);
+            //ein Rumpf, der ohne return endet, liefert wie im Interpreter den Nullwert
+            const Stmt* block = body->block;
+            bool returns = block->statement_count > 0 && block->statements[block->statement_count - 1]->kind == StmtKind::RETURN;
+            if (function_info.return_value_type.kind != ValueType::VOID && !returns)
+                line("return " + zero_value(function_info.return_value_type) + ";");
+            code += "}\n";
+        }
+
+        void line(const std::string& text) {
+            code.append(indent * 4, ' ');
+            code += text;
+            code += '\n';
+        }
+
+        void statements(const Stmt* block) {
+            for (uint32_t i = 0; i < block->statement_count; ++i)
+                statement(block->statements[i]);
+        }
+
+        void statement(const Stmt* stmt) {
+            switch (stmt->kind) {
+                case StmtKind::BLOCK:
+                    line("{");
+                    ++indent;
+                    statements(stmt);
+                    --indent;
+                    line("}");
+                    break;
+                case StmtKind::EXPR: {
+                    std::string value = expression(stmt->value);
+                    bool is_call = stmt->value->kind == ExprKind::CALL || stmt->value->kind == ExprKind::METHOD_CALL || stmt->value->kind == ExprKind::DIRECT_METHOD_CALL;
+                    line((is_call ? "" : "(void)") + value + ";");
+                    break;
+                }
+                case StmtKind::VAR_DECL:
+                    line(local_name(stmt->slot) + " = " + (stmt->value != nullptr ? expression(stmt->value) : zero_value(body->local_types[stmt->slot])) + ";");
+                    break;
+                case StmtKind::ASSIGN: {
+                    const Expr* target = stmt->target;
+                    if (target->kind == ExprKind::FIELD) {
+                        //der Interpreter wertet erst das Objekt, dann den Wert aus und prüft null erst beim Speichern
+                        std::vector<std::string> values = operands({target->left, stmt->value});
+                        line(member_access(target->left, values[0]) + "f_" + field_name(target) + " = " + values[1] + ";");
+                    } else {
+                        std::string value = expression(stmt->value);
+                        line(target->kind == ExprKind::LOCAL ? local_name(target->index) + " = " + value + ";" : "g_" + info.global_vars[target->index].name + " = " + value + ";");
+                    }
+                    break;
+                }
+                case StmtKind::RETURN:
+                    line(stmt->value != nullptr ? "return " + expression(stmt->value) + ";" : "return;");
+                    break;
+                case StmtKind::IF:
+                    line("if (" + condition(stmt->value) + ") {");
+                    branch(stmt->body);
+                    if (stmt->otherwise != nullptr) {
+                        line("} else {");
+                        branch(stmt->otherwise);
+                    }
+                    line("}");
+                    break;
+                case StmtKind::WHILE:
+                    //Aufrufe in der Bedingung brauchen Hilfsvariablen, die in jedem Durchlauf neu berechnet werden
+                    if (!has_call(stmt->value)) {
+                        line("while (" + condition(stmt->value) + ") {");
+                        branch(stmt->body);
+                        line("}");
+                    } else {
+                        line("while (true) {");
+                        ++indent;
+                        line("if (!(" + expression(stmt->value) + "))");
+                        line("    break;");
+                        --indent;
+                        branch(stmt->body);
+                        line("}");
+                    }
+                    break;
+            }
+        }
+
+        //ohne die äußeren Klammern eines Operators, die Bedingung steht schon in Klammern
+        std::string condition(const Expr* expr) {
+            std::string text = expression(expr);
+            if (text.size() < 2 || text.front() != '(' || text.back() != ')')
+                return text;
+            int depth = 0;
+            for (size_t i = 0; i + 1 < text.size(); ++i) {
+                depth += text[i] == '(' ? 1 : text[i] == ')' ? -1 : 0;
+                if (depth == 0)
+                    return text;
+            }
+            return text.substr(1, text.size() - 2);
+        }
+
+        //Rumpf von if und while ohne zusätzliche Klammern
+        void branch(const Stmt* stmt) {
+            ++indent;
+            if (stmt->kind == StmtKind::BLOCK)
+                statements(stmt);
+            else
+                statement(stmt);
+            --indent;
+        }
+
+        static bool is_literal(const Expr* expr) {
+            return expr->kind == ExprKind::NUMBER_LITERAL || expr->kind == ExprKind::STRING_LITERAL || expr->kind == ExprKind::BOOL_LITERAL;
+        }
+
+        //Werte, die kein Aufruf verändern kann
+        static bool is_stable(const Expr* expr) {
+            return is_literal(expr) || expr->kind == ExprKind::LOCAL || expr->kind == ExprKind::THIS;
+        }
+
+        static bool has_call(const Expr* expr) {
+            if (expr == nullptr)
+                return false;
+            if (expr->kind == ExprKind::CALL || expr->kind == ExprKind::METHOD_CALL || expr->kind == ExprKind::DIRECT_METHOD_CALL)
+                return true;
+            for (uint32_t i = 0; i < expr->arg_count; ++i) {
+                if (has_call(expr->args[i]))
+                    return true;
+            }
+            return has_call(expr->left) || has_call(expr->right);
+        }
+
+        std::string temp(const std::string& value) {
+            std::string name = "t" + std::to_string(temp_count++);
+            line("auto " + name + " = " + value + ";");
+            return name;
+        }
+
+        //C++ legt die Reihenfolge von Operanden und Argumenten nicht fest. Sobald einer davon etwas aufruft, landen alle
+        //veränderlichen in Hilfsvariablen, damit sie wie im Interpreter von links nach rechts ausgewertet werden
+        std::vector<std::string> operands(const std::vector<const Expr*>& exprs) {
+            size_t unstable = 0;
+            bool calls = false;
+            for (const Expr* expr : exprs) {
+                unstable += !is_stable(expr);
+                calls |= has_call(expr);
+            }
+            std::vector<std::string> values;
+            for (const Expr* expr : exprs) {
+                std::string value = expression(expr);
+                values.push_back(calls && unstable > 1 && !is_stable(expr) ? temp(value) : value);
+            }
+            return values;
+        }
+
+        std::string member_access(const Expr* object, const std::string& value) const {
+            if (object->kind == ExprKind::THIS)
+                return "this->";
+            return "coral::not_null(" + value + ", \"" + function_display_name + "\")->";
+        }
+
+        std::string field_name(const Expr* field) const {
+            return info.types[field->owner].fields[field->index].name;
+        }
+
+        std::string call(const Expr* expr) {
+            std::vector<const Expr*> exprs;
+            bool is_method = expr->kind != ExprKind::CALL;
+            if (is_method)
+                exprs.push_back(expr->left);
+            for (uint32_t i = 0; i < expr->arg_count; ++i)
+                exprs.push_back(expr->args[i]);
+            std::vector<std::string> values = operands(exprs);
+            std::string text;
+            if (expr->kind == ExprKind::METHOD_CALL)
+                text = member_access(expr->left, values[0]) + function_name(expr->index);
+            else if (expr->kind == ExprKind::DIRECT_METHOD_CALL)
+                text = member_access(expr->left, values[0]) + type_name(info.functions[expr->index].owner_type) + "::" + function_name(expr->index);
+            else
+                text = function_name(expr->index);
+            bool foreign = !is_method && is_foreign(expr->index);
+            text += "(";
+            for (size_t i = is_method ? 1 : 0; i < values.size(); ++i) {
+                if (i > (is_method ? 1u : 0u))
+                    text += ", ";
+                text += foreign && info.functions[expr->index].param_value_types[i].kind == ValueType::STRING ? "coral::c_str(" + values[i] + ")" : values[i];
+            }
+            const FunctionInfo& callee = info.functions[expr->index];
+            int native = is_method || !(callee.is_linked || callee.is_intrinsic) ? -1 : VM::find_native(callee);
+            if (native != -1 && VM::NATIVES[native].can_fail)
+                text += std::string(values.empty() ? "" : ", ") + "\"" + function_display_name + "\"";
+            text += ")";
+            return foreign && info.functions[expr->index].return_value_type.kind == ValueType::STRING ? "coral::from_c(" + text + ")" : text;
+        }
+
+        std::string expression(const Expr* expr) {
+            switch (expr->kind) {
+                case ExprKind::NUMBER_LITERAL:
+                    return number_literal(expr->number);
+                case ExprKind::STRING_LITERAL:
+                    return string_literal(expr->payload);
+                case ExprKind::BOOL_LITERAL:
+                    return expr->payload != 0 ? "true" : "false";
+                case ExprKind::LOCAL:
+                    return local_name(expr->index);
+                case ExprKind::GLOBAL:
+                    return "g_" + info.global_vars[expr->index].name;
+                case ExprKind::THIS:
+                    return "this";
+                case ExprKind::FIELD: {
+                    std::string object = expression(expr->left);
+                    return member_access(expr->left, object) + "f_" + field_name(expr);
+                }
+                case ExprKind::CALL:
+                case ExprKind::METHOD_CALL:
+                case ExprKind::DIRECT_METHOD_CALL:
+                    return call(expr);
+                case ExprKind::NEW:
+                    return "new " + type_name(expr->index) + "()";
+                case ExprKind::IS_TYPE: {
+                    const TypeInfo& type_info = info.types[expr->index];
+                    return "coral::is_type(" + expression(expr->left) + ", " + std::to_string(type_info.type_id) + ", " + std::to_string(type_info.last_subtype_id) + ")";
+                }
+                case ExprKind::UNARY:
+                    return std::string("(") + (expr->op == TokenType::BANG ? "!" : "-") + expression(expr->left) + ")";
+                case ExprKind::BINARY:
+                    return binary(expr);
+            }
+            return "";
+        }
+
+        std::string binary(const Expr* expr) {
+            TokenType op = expr->op;
+            if ((op == TokenType::AND_AND || op == TokenType::OR_OR) && has_call(expr->right)) {
+                //der rechte Operand darf nur ausgewertet werden, wenn der linke das Ergebnis nicht schon festlegt
+                std::string result = temp(expression(expr->left));
+                line(std::string("if (") + (op == TokenType::AND_AND ? "" : "!") + result + ") {");
+                ++indent;
+                line(result + " = " + expression(expr->right) + ";");
+                --indent;
+                line("}");
+                return result;
+            }
+            std::vector<std::string> values = operands({expr->left, expr->right});
+            const std::string& left = values[0];
+            const std::string& right = values[1];
+            bool is_string = expr->left->type.kind == ValueType::STRING;
+            switch (op) {
+                case TokenType::PLUS:
+                    return is_string ? "coral::concat(" + left + ", " + right + ")" : "(" + left + " + " + right + ")";
+                case TokenType::PERCENT:
+                    return "std::fmod(" + left + ", " + right + ")";
+                case TokenType::EQUALS_EQUALS:
+                    return is_string ? "coral::equals(" + left + ", " + right + ")" : "(" + left + " == " + right + ")";
+                case TokenType::NOT_EQUALS:
+                    return is_string ? "(!coral::equals(" + left + ", " + right + "))" : "(" + left + " != " + right + ")";
+                default:
+                    return "(" + left + " " + binary_operator(op) + " " + right + ")";
+            }
+        }
+
+        static const char* binary_operator(TokenType op) {
+            switch (op) {
+                case TokenType::MINUS: return "-";
+                case TokenType::STAR: return "*";
+                case TokenType::SLASH: return "/";
+                case TokenType::LESS: return "<";
+                case TokenType::GREATER: return ">";
+                case TokenType::LESS_EQUALS: return "<=";
+                case TokenType::GREATER_EQUALS: return ">=";
+                case TokenType::AND_AND: return "&&";
+                case TokenType::OR_OR: return "||";
+                default: return "?";
+            }
+        }
+    };
+
+}
+
+//coralc serve: ein langlebiger Prozess für Editoren und Watch Builds. Gesprochen wird JSON-RPC 2.0 mit Content-Length
+//Headern wie beim Language Server Protocol, über stdio oder einen Unix Socket. Ein geöffnetes Dokument behält Text,
+//Tokens und ParseInfo, nach einer Änderung werden nur die betroffenen Deklarationen neu gelesen und geparst
+namespace Server {
+
+    using namespace Parsing;
+
+    //Text eines Dokuments als Folge von Stücken aus dem ursprünglichen Text und einem Puffer für alles Eingefügte.
+    //Eine Änderung teilt höchstens zwei Stücke und hängt an den Puffer an, verschoben wird nur die Liste der Stücke
+    class PieceTable final {
+    public:
+        explicit PieceTable(std::string content = std::string()) {
+            reset(std::move(content));
+        }
+
+        size_t size() const {
+            return length;
+        }
+
+        //ersetzt removed Bytes ab offset durch inserted, offset + removed darf nicht hinter dem Ende liegen
+        void replace(size_t offset, size_t removed, std::string_view inserted) {
+            size_t index = split(offset);
+            size_t last = split(offset + removed);
+            pieces.erase(pieces.begin() + index, pieces.begin() + last);
+            if (!inserted.empty()) {
+                //beim Tippen wächst das zuletzt eingefügte Stück einfach weiter
+                if (index > 0 && pieces[index - 1].added && pieces[index - 1].start + pieces[index - 1].length == added.size())
+                    pieces[index - 1].length += inserted.size();
+                else
+                    pieces.insert(pieces.begin() + index, {true, added.size(), inserted.size()});
+                added.append(inserted.data(), inserted.size());
+            }
+            length = length - removed + inserted.size();
+            if (pieces.size() > MAX_PIECES)
+                reset(text());
+        }
+
+        //kopiert höchstens count Bytes ab offset, gibt die Anzahl zurück
+        size_t read(size_t offset, char* target, size_t count) const {
+            size_t position = 0, copied = 0;
+            for (const Piece& piece : pieces) {
+                if (copied == count)
+                    break;
+                if (offset + copied < position + piece.length) {
+                    size_t skip = offset + copied - position;
+                    size_t n = std::min(piece.length - skip, count - copied);
+                    memcpy(target + copied, data(piece) + skip, n);
+                    copied += n;
+                }
+                position += piece.length;
+            }
+            return copied;
+        }
+
+        std::string text() const {
+            std::string result;
+            result.reserve(length);
+            for (const Piece& piece : pieces)
+                result.append(data(piece), piece.length);
+            return result;
+        }
+
+        //Offsets der Zeilenanfänge, Zeile 0 beginnt bei 0
+        std::vector<uint32_t> line_starts() const {
+            std::vector<uint32_t> starts(1, 0);
+            size_t position = 0;
+            for (const Piece& piece : pieces) {
+                const char* begin = data(piece);
+                const char* end = begin + piece.length;
+                for (const char* p = begin; (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; ++p)
+                    starts.push_back(static_cast<uint32_t>(position + (p - begin) + 1));
+                position += piece.length;
+            }
+            return starts;
+        }
+
+    private:
+        //danach wird der Text wieder zu einem Stück zusammengefügt
+        static constexpr size_t MAX_PIECES = 1024;
+
+        struct Piece {
+            bool added;
+            size_t start;
+            size_t length;
+        };
+
+        std::string original;
+        std::string added;
+        std::vector<Piece> pieces;
+        size_t length = 0;
+
+        void reset(std::string content) {
+            original = std::move(content);
+            added.clear();
+            pieces.clear();
+            length = original.size();
+            if (length > 0)
+                pieces.push_back({false, 0, length});
+        }
+
+        const char* data(const Piece& piece) const {
+            return (piece.added ? added.data() : original.data()) + piece.start;
+        }
+
+        //sorgt dafür, dass bei offset ein Stück beginnt, und gibt dessen Index zurück
+        size_t split(size_t offset) {
+            size_t position = 0;
+            for (size_t i = 0; i < pieces.size(); ++i) {
+                if (position == offset)
+                    return i;
+                if (offset < position + pieces[i].length) {
+                    size_t head = offset - position;
+                    Piece tail = {pieces[i].added, pieces[i].start + head, pieces[i].length - head};
+                    pieces[i].length = head;
+                    pieces.insert(pieces.begin() + i + 1, tail);
+                    return i + 1;
+                }
+                position += pieces[i].length;
+            }
+            return pieces.size();
+        }
+    };
+
+    //eine Deklaration auf oberster Ebene mit ihren Tokens und dem Ergebnis des Parsers. Alle Offsets darin sind relativ
+    //zu start, Deklarationen hinter einer Änderung werden dadurch nur verschoben und nicht neu gelesen
+    struct Declaration {
+        uint32_t start = 0;
+        //endet mit ; oder } auf oberster Ebene, sonst läuft sie bis zum Ende des Dokuments
+        bool complete = false;
+        std::vector<Token> tokens;
+        ParseInfo info = {0, nullptr, 0, nullptr, 0, nullptr, nullptr};
+        Diagnostics::DiagnosticList diagnostics;
+
+        Declaration() = default;
+        Declaration(const Declaration&) = delete;
+        Declaration& operator=(const Declaration&) = delete;
+
+        ~Declaration() {
+            release_parse_info(info);
+        }
+
+        uint32_t end() const {
+            return start + tokens.back().offset + 1;
+        }
+    };
+
+    struct EditStats {
+        size_t relexed_tokens = 0;
+        size_t reparsed_declarations = 0;
+    };
+
+    class Document final {
+    public:
+        explicit Document(std::string content) : text(std::move(content)), interner(arena) {
+            rebuild(0, 0, UINT64_MAX, 0);
+        }
+
+        const PieceTable& get_text() const {
+            return text;
+        }
+
+        const std::vector<std::unique_ptr<Declaration>>& get_declarations() const {
+            return declarations;
+        }
+
+        const Util::StringInterner& get_interner() const {
+            return interner;
+        }
+
+        size_t token_count() const {
+            return tokens;
+        }
+
+        //Offsets in Bytes, offset + removed darf nicht hinter dem Ende liegen
+        EditStats edit(size_t offset, size_t removed, std::string_view inserted) {
+            text.replace(offset, removed, inserted);
+            //gelesen wird ab der Deklaration, in der die Änderung liegt. Liegt sie hinter einer abgeschlossenen
+            //Deklaration, reicht deren Ende, dazwischen stehen nur Leerzeichen und Kommentare
+            size_t first = std::upper_bound(declarations.begin(), declarations.end(), offset,
+                [](size_t value, const std::unique_ptr<Declaration>& declaration) { return value < declaration->start; }) - declarations.begin();
+            uint64_t lex_start = 0;
+            if (first > 0) {
+                const Declaration& previous = *declarations[first - 1];
+                if (previous.complete && offset >= previous.end()) {
+                    lex_start = previous.end();
+                } else {
+                    --first;
+                    lex_start = previous.start;
+                }
+            }
+            return rebuild(first, lex_start, offset + inserted.size(), static_cast<int64_t>(inserted.size()) - static_cast<int64_t>(removed));
+        }
+
+    private:
+        //kleine Blöcke, meistens endet das Lesen schon nach wenigen Deklarationen
+        static constexpr size_t RELEX_CHUNK_SIZE = 4096;
+
+        PieceTable text;
+        Util::Arena arena;
+        Util::StringInterner interner;
+        std::vector<std::unique_ptr<Declaration>> declarations;
+        size_t tokens = 0;
+
+        //liest ab lex_start neu, bis eine alte Deklaration ab first hinter damage_end unverändert wieder beginnt. Alte
+        //Offsets plus delta ergeben die neuen
+        EditStats rebuild(size_t first, uint64_t lex_start, uint64_t damage_end, int64_t delta) {
+            EditStats stats;
+            Util::ChunkedReader reader(RELEX_CHUNK_SIZE);
+            uint64_t position = lex_start;
+            reader.open([this, &position](char* target, size_t count) {
+                size_t copied = text.read(position, target, count);
+                position += copied;
+                return copied;
+            }, lex_start);
+            Diagnostics::DiagnosticList lex_diagnostics;
+            Tokenization::Tokenizer tokenizer(reader, interner, &lex_diagnostics);
+
+            std::vector<std::unique_ptr<Declaration>> rebuilt;
+            std::unique_ptr<Declaration> current;
+            int depth = 0;
+            size_t reuse = first;
+            bool resynchronized = false;
+            Token token;
+            while (tokenizer.next(token)) {
+                if (current == nullptr) {
+                    while (reuse < declarations.size() && declarations[reuse]->start + delta < token.offset)
+                        ++reuse;
+                    if (reuse < declarations.size() && declarations[reuse]->start + delta == token.offset && token.offset >= damage_end) {
+                        resynchronized = true;
+                        break;
+                    }
+                    current.reset(new Declaration());
+                    current->start = token.offset;
+                    depth = 0;
+                }
+                ++stats.relexed_tokens;
+                token.offset -= current->start;
+                current->tokens.push_back(token);
+                if (token.type == TokenType::OPEN_CURLY) {
+                    ++depth;
+                } else if ((token.type == TokenType::CLOSE_CURLY && --depth <= 0) || (token.type == TokenType::SEMICOLON && depth == 0)) {
+                    current->complete = true;
+                    rebuilt.push_back(std::move(current));
+                }
+            }
+            if (current != nullptr)
+                rebuilt.push_back(std::move(current));
+            size_t resume = resynchronized ? reuse : declarations.size();
+
+            //Meldungen des Tokenizers gehören zu der Deklaration, in der sie liegen. Das Token an der Stelle, an der
+            //wieder aufgesetzt wurde, gehört zu einer alten Deklaration, die ihre Meldungen schon hat
+            for (const Diagnostics::Diagnostic& diagnostic : lex_diagnostics.get_items()) {
+                if (resynchronized && diagnostic.offset >= token.offset)
+                    continue;
+                if (rebuilt.empty()) {
+                    rebuilt.emplace_back(new Declaration());
+                    rebuilt.back()->start = static_cast<uint32_t>(lex_start);
+                }
+                size_t index = std::upper_bound(rebuilt.begin(), rebuilt.end(), diagnostic.offset,
+                    [](uint32_t value, const std::unique_ptr<Declaration>& declaration) { return value < declaration->start; }) - rebuilt.begin();
+                Declaration& owner = *rebuilt[index == 0 ? 0 : index - 1];
+                owner.diagnostics.report(diagnostic.severity, 0, diagnostic.offset - std::min(diagnostic.offset, owner.start), diagnostic.message);
+            }
+            for (std::unique_ptr<Declaration>& declaration : rebuilt) {
+                Tokenization::VectorTokenSource source(declaration->tokens);
+                Parser parser(source, interner, declaration->diagnostics, true);
+                declaration->info = parser.parse();
+                tokens += declaration->tokens.size();
+            }
+            stats.reparsed_declarations = rebuilt.size();
+
+            for (size_t i = first; i < resume; ++i)
+                tokens -= declarations[i]->tokens.size();
+            for (size_t i = resume; i < declarations.size(); ++i)
+                declarations[i]->start = static_cast<uint32_t>(declarations[i]->start + delta);
+            declarations.erase(declarations.begin() + first, declarations.begin() + resume);
+            declarations.insert(declarations.begin() + first, std::make_move_iterator(rebuilt.begin()), std::make_move_iterator(rebuilt.end()));
+            return stats;
+        }
+    };
+
+    struct JsonValue {
+        enum Kind : uint8_t {
+            NUL,
+            BOOLEAN,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        Kind kind = NUL;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+        std::vector<JsonValue> items;
+        std::vector<std::pair<std::string, JsonValue>> members;
+
+        const JsonValue* get(const char* key) const {
+            for (const auto& member : members) {
+                if (member.first == key)
+                    return &member.second;
+            }
+            return nullptr;
+        }
+    };
+
+    class JsonReader final {
+    public:
+        explicit JsonReader(std::string_view text) : cursor(text.data()), end(text.data() + text.size()) {
+        }
+
+        bool read(JsonValue& value) {
+            if (!parse_value(value, 0))
+                return false;
+            skip_whitespace();
+            return cursor == end;
+        }
+
+    private:
+        static constexpr int MAX_DEPTH = 64;
+
+        const char* cursor;
+        const char* end;
+
+        void skip_whitespace() {
+            while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+                ++cursor;
+        }
+
+        bool match(const char* word) {
+            size_t size = strlen(word);
+            if (static_cast<size_t>(end - cursor) < size || memcmp(cursor, word, size) != 0)
+                return false;
+            cursor += size;
+            return true;
+        }
+
+        bool parse_value(JsonValue& value, int depth) {
+            skip_whitespace();
+            if (cursor == end || depth > MAX_DEPTH)
+                return false;
+            switch (*cursor) {
+                case '{': {
+                    value.kind = JsonValue::OBJECT;
+                    ++cursor;
+                    skip_whitespace();
+                    if (cursor < end && *cursor == '}') {
+                        ++cursor;
+                        return true;
+                    }
+                    while (true) {
+                        skip_whitespace();
+                        std::pair<std::string, JsonValue> member;
+                        if (cursor == end || *cursor != '"' || !parse_string(member.first))
+                            return false;
+                        skip_whitespace();
+                        if (cursor == end || *cursor++ != ':' || !parse_value(member.second, depth + 1))
+                            return false;
+                        value.members.push_back(std::move(member));
+                        skip_whitespace();
+                        if (cursor == end)
+                            return false;
+                        if (*cursor == '}') {
+                            ++cursor;
+                            return true;
+                        }
+                        if (*cursor++ != ',')
+                            return false;
+                    }
+                }
+                case '[': {
+                    value.kind = JsonValue::ARRAY;
+                    ++cursor;
+                    skip_whitespace();
+                    if (cursor < end && *cursor == ']') {
+                        ++cursor;
+                        return true;
+                    }
+                    while (true) {
+                        value.items.emplace_back();
+                        if (!parse_value(value.items.back(), depth + 1))
+                            return false;
+                        skip_whitespace();
+                        if (cursor == end)
+                            return false;
+                        if (*cursor == ']') {
+                            ++cursor;
+                            return true;
+                        }
+                        if (*cursor++ != ',')
+                            return false;
+                    }
+                }
+                case '"':
+                    value.kind = JsonValue::STRING;
+                    return parse_string(value.string);
+                case 't':
+                    value.kind = JsonValue::BOOLEAN;
+                    value.boolean = true;
+                    return match("true");
+                case 'f':
+                    value.kind = JsonValue::BOOLEAN;
+                    return match("false");
+                case 'n':
+                    return match("null");
+                default: {
+                    const char* start = cursor;
+                    while (cursor < end && (isdigit(static_cast<unsigned char>(*cursor)) || *cursor == '-' || *cursor == '+' || *cursor == '.' || *cursor == 'e' || *cursor == 'E'))
+                        ++cursor;
+                    if (cursor == start)
+                        return false;
+                    std::string number(start, cursor);
+                    char* number_end = nullptr;
+                    value.kind = JsonValue::NUMBER;
+                    value.number = strtod(number.c_str(), &number_end);
+                    return number_end == number.c_str() + number.size();
+                }
+            }
+        }
+
+        bool parse_hex4(uint32_t& code) {
+            if (end - cursor < 4)
+                return false;
+            code = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = *cursor++;
+                code <<= 4;
+                if (c >= '0' && c <= '9') code |= c - '0';
+                else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+                else return false;
+            }
+            return true;
+        }
+
+        //Cursor steht auf dem öffnenden "
+        bool parse_string(std::string& target) {
+            ++cursor;
+            while (cursor < end) {
+                char c = *cursor++;
+                if (c == '"')
+                    return true;
+                if (c != '\\') {
+                    target.push_back(c);
+                    continue;
+                }
+                if (cursor == end)
+                    return false;
+                switch (*cursor++) {
+                    case '"': target.push_back('"'); break;
+                    case '\\': target.push_back('\\'); break;
+                    case '/': target.push_back('/'); break;
+                    case 'b': target.push_back('\b'); break;
+                    case 'f': target.push_back('\f'); break;
+                    case 'n': target.push_back('\n'); break;
+                    case 'r': target.push_back('\r'); break;
+                    case 't': target.push_back('\t'); break;
+                    case 'u': {
+                        uint32_t code;
+                        if (!parse_hex4(code))
+                            return false;
+                        //Surrogate Paare ergeben einen Code Point außerhalb der BMP
+                        if (code >= 0xD800 && code < 0xDC00) {
+                            uint32_t low;
+                            if (!match("\\u") || !parse_hex4(low) || low < 0xDC00 || low >= 0xE000)
+                                return false;
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        append_utf8(target, code);
+                        break;
+                    }
+                    default:
+                        return false;
                 }
             }
-            //Anführungszeichen am Ende entfernen
-            consume();
-            Token token;
-            token.type = TokenType::STR_LITERAL;
-            TokenValue *token_value = new TokenValue();
-            token_value->str_value = new std::string(string_builder.str());
-            token.value = token_value;
-            this->tokens.push_back(token);
+            return false;
+        }
+
+        static void append_utf8(std::string& target, uint32_t code) {
+            if (code < 0x80) {
+                target.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                target.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else if (code < 0x10000) {
+                target.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                target.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                target.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                target.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                target.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+    };
+
+    std::string json_string(std::string_view text) {
+        std::string result = "\"";
+        for (char c : text) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                        result += escaped;
+                    } else {
+                        result.push_back(c);
+                    }
+            }
+        }
+        return result + "\"";
+    }
+
+    //liest und schreibt Nachrichten mit einem "Content-Length: n" Header wie beim Language Server Protocol
+    class MessageChannel final {
+    public:
+        MessageChannel(int input, int output) : input(input), output(output) {
+        }
+
+        bool read(std::string& body) {
+            size_t content_length = SIZE_MAX;
+            std::string line;
+            while (true) {
+                if (!read_line(line))
+                    return false;
+                if (line.empty() && content_length != SIZE_MAX)
+                    break;
+                if (line.size() > 15 && strncasecmp(line.c_str(), "Content-Length:", 15) == 0)
+                    content_length = strtoull(line.c_str() + 15, nullptr, 10);
+            }
+            while (buffer.size() - consumed < content_length) {
+                if (!fill())
+                    return false;
+            }
+            body.assign(buffer, consumed, content_length);
+            consumed += content_length;
+            return true;
+        }
+
+        bool write(const std::string& body) {
+            std::string message = "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            const char* data = message.data();
+            size_t remaining = message.size();
+            while (remaining > 0) {
+                ssize_t written = ::write(output, data, remaining);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+                data += written;
+                remaining -= written;
+            }
+            return true;
         }
 
-        void parse_name_or_symbol() {
-            Token token;
-            char c = consume();
-            if (is_symbol(c)) {
-                token.type = get_symbol_type(c);
-            } else {
-                std::stringstream string_builder;
-                string_builder << c;
-                while (!Util::is_whitespace(current()) && !is_symbol(current()) && !is_eof()) {
-                    string_builder << consume();
-                }
-                TokenValue *token_value = new TokenValue();
-                const char* value = string_builder.str().c_str();
-                token.value = token_value;
-                //printf("got name token with value %s\n", value);
-                if (Util::str_starts_with(value, "function")) {
-                    token.type = TokenType::DECL_FUNCTION;
-                    token.value->str_value = new std::string(Util::substr_till_one_before_end(value, 10).c_str());
-                } else if (Util::str_equals(value, "false")) {
-                    token.type = TokenType::BOOL_LITERAL;
-                    token.value->bool_value = false;
-                } else if (Util::str_equals(value, "true")) {
-                    token.type = TokenType::BOOL_LITERAL;
-                    token.value->bool_value = true;
-                } else if (Util::str_equals(value, "intrinsic")) {
-                    token.type = TokenType::INTRINSIC;
-                    delete token.value;
-                } else if (Util::str_equals(value, "linked")) {
-                    token.type = TokenType::LINKED;
-                    delete token.value;
-                } else if (Util::str_equals(value, "bool")) {
-                    token.type = TokenType::BOOL;
-                    delete token.value;
-                } else if (Util::str_equals(value, "string")) {
-                    token.type = TokenType::STR;
-                    delete token.value;
-                } else if (Util::str_equals(value, "number")) {
-                    token.type = TokenType::NUM;
-                    delete token.value;
-                } else if (Util::str_equals(value, "type")) {
-                    token.type = TokenType::TYPE;
-                    delete token.value;
-                } else if (Util::str_equals(value, "from")) {
-                    token.type = TokenType::FROM;
-                    delete token.value;
-                } else if (Util::is_str_number(value)) {
-                    float num = std::stof(value);
-                    token.type = TokenType::NUM_LITERAL;
-                    token.value->float_value = num;
-                } else {
-                    token.type = TokenType::NAME;
-                    token.value->str_value = new std::string(value);
-                }
+    private:
+        int input;
+        int output;
+        std::string buffer;
+        size_t consumed = 0;
+
+        bool fill() {
+            if (consumed > 0) {
+                buffer.erase(0, consumed);
+                consumed = 0;
             }
-            this->tokens.push_back(token);
+            char chunk[64 * 1024];
+            ssize_t count;
+            do {
+                count = ::read(input, chunk, sizeof(chunk));
+            } while (count < 0 && errno == EINTR);
+            if (count <= 0)
+                return false;
+            buffer.append(chunk, count);
+            return true;
         }
 
+        //eine Headerzeile ohne \r\n
+        bool read_line(std::string& line) {
+            size_t newline;
+            while ((newline = buffer.find('\n', consumed)) == std::string::npos) {
+                if (!fill())
+                    return false;
+            }
+            line.assign(buffer, consumed, newline - consumed);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            consumed = newline + 1;
+            return true;
+        }
     };
-}
 
-namespace Parsing {
+    //Fehlercodes aus JSON-RPC 2.0
+    constexpr int PARSE_ERROR = -32700;
+    constexpr int INVALID_REQUEST = -32600;
+    constexpr int METHOD_NOT_FOUND = -32601;
+    constexpr int INVALID_PARAMS = -32602;
 
-    using namespace Tokenization;
+    class Server final {
+    public:
+        //bearbeitet Anfragen bis die Verbindung endet, false nach shutdown oder exit
+        bool serve(MessageChannel& channel) {
+            std::string body;
+            while (channel.read(body)) {
+                JsonValue request;
+                if (!JsonReader(body).read(request)) {
+                    channel.write(error_response("null", PARSE_ERROR, "Parse error"));
+                    continue;
+                }
+                const JsonValue* id = request.get("id");
+                const JsonValue* method = request.get("method");
+                std::string id_text = id == nullptr ? "null" : id->kind == JsonValue::STRING ? json_string(id->string) : format_number(id->number);
+                if (request.kind != JsonValue::OBJECT || method == nullptr || method->kind != JsonValue::STRING) {
+                    channel.write(error_response(id_text, INVALID_REQUEST, "Invalid request"));
+                    continue;
+                }
+                static const JsonValue no_params;
+                const JsonValue* params = request.get("params");
+                std::string result, message;
+                int code = dispatch(method->string, params == nullptr ? no_params : *params, result, message);
+                //Benachrichtigungen ohne id bekommen keine Antwort
+                if (id != nullptr) {
+                    if (code == 0)
+                        channel.write("{\"jsonrpc\":\"2.0\",\"id\":" + id_text + ",\"result\":" + result + "}");
+                    else
+                        channel.write(error_response(id_text, code, message));
+                }
+                if (method->string == "shutdown" || method->string == "exit")
+                    return false;
+            }
+            return true;
+        }
 
-    struct FieldInfo {
-        std::string name;
-        std::string type;
-    };
+    private:
+        std::unordered_map<std::string, std::unique_ptr<Document>> documents;
 
-    struct TypeInfo {
-        std::string name;
-        std::string super_type;
-        size_t field_count;
-        FieldInfo* fields;
-    };
+        static std::string format_number(double number) {
+            char text[32];
+            snprintf(text, sizeof(text), "%.17g", number);
+            return text;
+        }
 
-    struct FunctionInfo {
-        std::string name;
-        std::string return_type;
-        size_t param_count;
-        std::string* param_types;
-        std::vector<Token> code;
-    };
+        static std::string error_response(const std::string& id, int code, const std::string& message) {
+            return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"error\":{\"code\":" + std::to_string(code) + ",\"message\":" + json_string(message) + "}}";
+        }
 
-    struct GlobalVarInfo {
-        std::string type;
-        std::string name;
-    };
+        static const std::string* string_param(const JsonValue& params, const char* key) {
+            const JsonValue* value = params.get(key);
+            return value != nullptr && value->kind == JsonValue::STRING ? &value->string : nullptr;
+        }
 
-    struct ParseInfo {
-        size_t type_count;
-        TypeInfo* types;
-        size_t function_count;
-        FunctionInfo* functions;
-        size_t global_var_count;
-        GlobalVarInfo* global_vars;
-    };
+        static bool offset_param(const JsonValue& params, const char* key, size_t& target) {
+            const JsonValue* value = params.get(key);
+            if (value == nullptr || value->kind != JsonValue::NUMBER || value->number < 0 || value->number != std::floor(value->number) || value->number > UINT32_MAX)
+                return false;
+            target = static_cast<size_t>(value->number);
+            return true;
+        }
 
-    void print_parse_info(ParseInfo info) {
-        printf("Parse Info:\n");
-        printf("=============\n");
-        printf("Types:\n");
-        for (int i = 0; i < info.type_count; ++i) {
-            TypeInfo type_info = info.types[i];
-            printf("type #%d: ",i);
-            printf(type_info.name.c_str());
-            printf(", super-type: ");
-            printf(type_info.super_type.c_str());
-            printf("\n");
-            for (int j = 0; j < type_info.field_count; j++) {
-                printf("   %s %s\n", type_info.fields[i].name.c_str(), type_info.fields[i].type.c_str());
+        //gibt 0 oder einen Fehlercode zurück
+        int dispatch(const std::string& method, const JsonValue& params, std::string& result, std::string& message) {
+            if (method == "shutdown" || method == "exit") {
+                result = "null";
+                return 0;
+            }
+            const std::string* uri = string_param(params, "uri");
+            if (uri == nullptr) {
+                bool known = method == "open" || method == "change" || method == "close" || method == "outline" || method == "text";
+                message = known ? "Missing uri" : "Unknown method: " + method;
+                return known ? INVALID_PARAMS : METHOD_NOT_FOUND;
+            }
+            if (method == "open") {
+                const std::string* text = string_param(params, "text");
+                if (text == nullptr || text->size() > UINT32_MAX) {
+                    message = "Missing text";
+                    return INVALID_PARAMS;
+                }
+                auto start = std::chrono::steady_clock::now();
+                std::unique_ptr<Document>& document = documents[*uri];
+                document.reset(new Document(*text));
+                EditStats stats;
+                stats.relexed_tokens = document->token_count();
+                stats.reparsed_declarations = document->get_declarations().size();
+                result = document_result(*document, stats, start);
+                return 0;
+            }
+            auto found = documents.find(*uri);
+            if (found == documents.end()) {
+                bool known = method == "change" || method == "close" || method == "outline" || method == "text";
+                message = known ? "Unknown document: " + *uri : "Unknown method: " + method;
+                return known ? INVALID_PARAMS : METHOD_NOT_FOUND;
             }
+            Document& document = *found->second;
+            if (method == "change") {
+                size_t offset, length;
+                const std::string* text = string_param(params, "text");
+                if (!offset_param(params, "offset", offset) || !offset_param(params, "length", length) || text == nullptr
+                        || offset + length > document.get_text().size() || document.get_text().size() - length + text->size() > UINT32_MAX) {
+                    message = "Expected offset, length and text inside the document";
+                    return INVALID_PARAMS;
+                }
+                auto start = std::chrono::steady_clock::now();
+                EditStats stats = document.edit(offset, length, *text);
+                result = document_result(document, stats, start);
+            } else if (method == "close") {
+                documents.erase(found);
+                result = "null";
+            } else if (method == "outline") {
+                result = outline(document);
+            } else if (method == "text") {
+                result = json_string(document.get_text().text());
+            } else {
+                message = "Unknown method: " + method;
+                return METHOD_NOT_FOUND;
+            }
+            return 0;
         }
-    }
 
-    class Parser final {
-    public:
-        Parser(std::vector<Token> tokens) {
-            this->tokens = tokens;
+        //Meldungen mit absoluten Offsets, Zeilen und Spalten zählen ab 1 und in Bytes
+        static std::string document_result(const Document& document, const EditStats& stats, std::chrono::steady_clock::time_point start) {
+            uint64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            std::string diagnostics;
+            std::vector<uint32_t> line_starts;
+            for (const std::unique_ptr<Declaration>& declaration : document.get_declarations()) {
+                for (const Diagnostics::Diagnostic& diagnostic : declaration->diagnostics.get_items()) {
+                    if (line_starts.empty())
+                        line_starts = document.get_text().line_starts();
+                    uint32_t offset = declaration->start + diagnostic.offset;
+                    size_t line = std::upper_bound(line_starts.begin(), line_starts.end(), offset) - line_starts.begin();
+                    if (!diagnostics.empty())
+                        diagnostics += ",";
+                    diagnostics += "{\"severity\":\"" + std::string(Diagnostics::severity_to_string(diagnostic.severity)) + "\",\"offset\":" + std::to_string(offset)
+                        + ",\"line\":" + std::to_string(line) + ",\"column\":" + std::to_string(offset - line_starts[line - 1] + 1)
+                        + ",\"message\":" + json_string(diagnostic.message) + "}";
+                }
+            }
+            return "{\"diagnostics\":[" + diagnostics + "],\"declarations\":" + std::to_string(document.get_declarations().size())
+                + ",\"tokens\":" + std::to_string(document.token_count()) + ",\"relexed_tokens\":" + std::to_string(stats.relexed_tokens)
+                + ",\"reparsed_declarations\":" + std::to_string(stats.reparsed_declarations) + ",\"microseconds\":" + std::to_string(microseconds) + "}";
         }
 
-        ParseInfo parse() {
-            while (!is_eof()) {
-                Token current_token = current();
-                if (current_token.type == TokenType::DECL_FUNCTION) {
-                    parse_function();
-                } else if (current_token.type == TokenType::TYPE) {
-                    parse_type();
-                } else {
-                    parse_global_var();
+        static std::string outline_entry(const char* kind, const std::string& name, uint32_t offset) {
+            return "{\"kind\":\"" + std::string(kind) + "\",\"name\":" + json_string(name) + ",\"offset\":" + std::to_string(offset) + "}";
+        }
+
+        static std::string outline(const Document& document) {
+            std::string entries;
+            for (const std::unique_ptr<Declaration>& declaration : document.get_declarations()) {
+                const ParseInfo& info = declaration->info;
+                for (size_t i = 0; i < info.type_count; ++i)
+                    entries += (entries.empty() ? "" : ",") + outline_entry("type", info.types[i].name, declaration->start + info.types[i].offset);
+                for (size_t i = 0; i < info.function_count; ++i) {
+                    const FunctionInfo& function = info.functions[i];
+                    std::string name = function.owner_type >= 0 ? info.types[function.owner_type].name + "." + function.name : function.name;
+                    entries += (entries.empty() ? "" : ",") + outline_entry("function", name, declaration->start + function.offset);
                 }
+                for (size_t i = 0; i < info.global_var_count; ++i)
+                    entries += (entries.empty() ? "" : ",") + outline_entry("global", info.global_vars[i].name, declaration->start + info.global_vars[i].offset);
             }
-
-            //Ergebnisse in ein ParseInfo Object kopieren und dann zurückgeben
-            ParseInfo parse_result;
-            //Type Info kopieren
-            parse_result.type_count = types.size();
-            parse_result.types = new TypeInfo[types.size()];
-            for (int i = 0; i < types.size(); ++i)
-                parse_result.types[i] = types[i];
-            //Function Info kopieren
-            parse_result.function_count = functions.size();
-            parse_result.functions = new FunctionInfo[functions.size()];
-            for (int i = 0; i < functions.size(); ++i)
-                parse_result.functions[i] = functions[i];
-            //Global Var Info kopieren
-            parse_result.global_var_count = global_vars.size();
-            parse_result.global_vars = new GlobalVarInfo[global_vars.size()];
-            for (int i = 0; i < global_vars.size(); ++i)
-                parse_result.global_vars[i] = global_vars[i];
-            return parse_result;
+            return "[" + entries + "]";
         }
+    };
 
-    private:
-        std::vector<Token> tokens;
-        size_t pointer = 0;
-        std::vector<std::string> taken_identifiers;
-        //zur Zwischenspeicherung der Ergebnisse
-        std::vector<TypeInfo> types;
-        std::vector<FunctionInfo> functions;
-        std::vector<GlobalVarInfo> global_vars;
+    int serve_socket(Server& server, const std::string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            printf("Socket path too long: %s\n", path.c_str());
+            return -1;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(path.c_str());
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 4) != 0) {
+            printf("Could not listen on %s: %s\n", path.c_str(), strerror(errno));
+            if (listener >= 0)
+                close(listener);
+            return -1;
+        }
+        //Verbindungen werden nacheinander bedient, die Dokumente bleiben dazwischen erhalten
+        bool running = true;
+        while (running) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            MessageChannel channel(client, client);
+            running = server.serve(channel);
+            close(client);
+        }
+        close(listener);
+        unlink(path.c_str());
+        return 0;
+    }
 
-        Token consume() {
-            if (is_eof()) {
-                Util::error("Unexpectedly ran into end of file while parsing");
+    //coralc serve [--socket path]. Ohne --socket über stdin und stdout
+    int serve_main(int argc, const char** argv) {
+        std::string socket_path;
+        for (int i = 0; i < argc; ++i) {
+            if (Util::str_equals(argv[i], "--socket") && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else {
+                printf("Unknown or invalid option: %s\n", argv[i]);
+                return -1;
             }
-            Token token = current();
-            ++pointer;
-            return token;
         }
+        //ein Client, der die Verbindung schließt, soll den Server nicht beenden
+        signal(SIGPIPE, SIG_IGN);
+        Server server;
+        if (!socket_path.empty())
+            return serve_socket(server, socket_path);
+        MessageChannel channel(STDIN_FILENO, STDOUT_FILENO);
+        server.serve(channel);
+        return 0;
+    }
+
+}
+
+//Benchmarks für das Frontend: ein deterministischer Generator für .crl Quellen und eine Messung des Durchsatzes von
+//read_file, Tokenizer und Parser. Aufruf über coralc gen-corpus und coralc bench
+namespace Bench {
+
+    struct CorpusOptions {
+        size_t target_bytes = 8 * 1024 * 1024;
+        uint64_t seed = 1;
+        //Länge der Vererbungsketten
+        size_t hierarchy_depth = 6;
+        size_t max_fields = 24;
+        size_t string_length = 200;
+        //Anzahl der Zahlenliterale pro Ausdruck
+        size_t numbers_per_expression = 8;
+        //Verschachtelungstiefe der Funktionsrümpfe
+        size_t body_depth = 6;
+    };
 
-        Token current() {
-            return tokens[pointer];
+    //splitmix64, damit der Korpus bei gleichem Seed auf jeder Plattform gleich aussieht
+    class Random final {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {
         }
 
-        Token ahead(int skips = 0) {
-            int new_pointer = pointer + 1 + skips;
-            if (new_pointer >= tokens.size())
-                new_pointer = tokens.size()-1;
-            return tokens[new_pointer];
+        uint64_t next() {
+            uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+            return value ^ (value >> 31);
         }
 
-        bool is_eof() {
-            return pointer >= tokens.size();
+        size_t below(size_t bound) {
+            return bound == 0 ? 0 : static_cast<size_t>(next() % bound);
         }
 
-        bool identifier_exists(std::string identifier) {
-            for (int i = 0; i < taken_identifiers.size(); ++i) {
-                if (Util::str_equals(identifier.c_str(), taken_identifiers[i].c_str()))
-                    return true;
-            }
-            return false;
+    private:
+        uint64_t state;
+    };
+
+    class CorpusGenerator final {
+    public:
+        explicit CorpusGenerator(const CorpusOptions& options) : options(options), random(options.seed) {
         }
 
-        bool type_exists(std::string name) {
-            for (int i = 0; i < types.size(); ++i) {
-                if (Util::str_equals(name.c_str(), types[i].name.c_str()))
-                    return true;
+        std::string generate() {
+            while (output.size() < options.target_bytes) {
+                switch (random.below(4)) {
+                    case 0:
+                    case 1:
+                        generate_hierarchy();
+                        break;
+                    case 2:
+                        generate_globals();
+                        break;
+                    default:
+                        generate_function();
+                        break;
+                }
             }
-            return false;
+            return std::move(output);
         }
 
-        void parse_type() {
-            TypeInfo type_info;
-            //"type" keyword entfernen
-            consume();
-            //zuerst werden Name und Name der Superklasse entnommen
-            Token name_token = consume();
-            if (name_token.type != TokenType::NAME) {
-                Util::error("Expected name after type declaration");
-            }
-            std::string type_name = *(name_token.value->str_value);
-            if (identifier_exists(type_name)) {
-                printf("Identifier is already taken: %s", type_name.c_str());
-                exit(-1);
+    private:
+        const CorpusOptions& options;
+        Random random;
+        std::string output;
+        size_t type_count = 0, function_count = 0, global_count = 0;
+        //jede Funktion bekommt eigene Namen für ihre Variablen, die Tiefe ist dadurch beliebig
+        size_t variable_count = 0;
+
+        void append_number() {
+            char text[32];
+            if (random.below(2) == 0)
+                snprintf(text, sizeof(text), "%zu", random.below(100000));
+            else
+                snprintf(text, sizeof(text), "%zu.%zu", random.below(1000), random.below(1000));
+            output += text;
+        }
+
+        void append_number_expression(const std::string& variable) {
+            static const char* OPERATORS[] = {" + ", " - ", " * "};
+            output += variable;
+            for (size_t i = 0; i < options.numbers_per_expression; ++i) {
+                output += OPERATORS[random.below(3)];
+                append_number();
             }
-            type_info.name = type_name;
-            Token next_token = consume();
-            if (next_token.type == TokenType::FROM) {
-                name_token = consume();
-                if (name_token.type != TokenType::NAME) {
-                    Util::error("Expected name after from clause");
-                }
-                type_name = *(name_token.value->str_value);
-                if (!type_exists(type_name)) {
-                    Util::error("type in from clause does not exist");
+        }
+
+        void append_string_literal() {
+            static const char LETTERS[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+            output += '"';
+            size_t length = options.string_length / 2 + random.below(options.string_length);
+            for (size_t i = 0; i < length; ++i)
+                output += LETTERS[random.below(sizeof(LETTERS) - 1)];
+            output += '"';
+        }
+
+        void generate_hierarchy() {
+            size_t depth = 1 + random.below(options.hierarchy_depth);
+            for (size_t level = 0; level < depth; ++level) {
+                size_t type_index = type_count++;
+                output += "type T" + std::to_string(type_index);
+                if (level > 0)
+                    output += " from T" + std::to_string(type_index - 1);
+                output += " {\n";
+                size_t field_count = 1 + random.below(options.max_fields);
+                for (size_t i = 0; i < field_count; ++i) {
+                    static const char* FIELD_TYPES[] = {"number", "string", "bool"};
+                    //Feldnamen enthalten den Typ, damit geerbte Felder nie verdeckt werden
+                    const char* field_type = FIELD_TYPES[random.below(3)];
+                    std::string reference_type;
+                    if (type_index > 0 && random.below(8) == 0) {
+                        reference_type = "T" + std::to_string(random.below(type_index));
+                        field_type = reference_type.c_str();
+                    }
+                    output += "    ";
+                    output += field_type;
+                    output += " f" + std::to_string(type_index) + "_" + std::to_string(i) + ";\n";
                 }
-                type_info.super_type = type_name;
-                next_token = consume();
-            }
-            if (next_token.type != TokenType::OPEN_CURLY) {
-                Util::error("Expected open curly brace after type declaration");
+                output += "\n    function<number> m" + std::to_string(type_index) + "(number a) {\n";
+                output += "        return ";
+                append_number_expression("a");
+                output += ";\n    }\n}\n\n";
             }
+        }
 
-            //nun werden Attribute und Methoden entnommen
-            std::vector<FieldInfo> fields;
-            next_token = consume();
-            while(next_token.type != TokenType::CLOSE_CURLY) {
-                if (next_token.type == TokenType::DECL_FUNCTION) {
-                    //das Entnehmen von Member Functions wird in eine eigene Methode ausgelagert, da die Member Functions nicht Teil des Datentyps sind, sondern nur einen versteckten Parameter haben
-                    parse_member_function(type_info);
+        void generate_globals() {
+            size_t count = 1 + random.below(8);
+            for (size_t i = 0; i < count; ++i) {
+                size_t global_index = global_count++;
+                if (random.below(2) == 0) {
+                    output += "string s" + std::to_string(global_index) + " = ";
+                    append_string_literal();
                 } else {
-                    FieldInfo field_info;
-                    if (next_token.type == TokenType::NAME) {
-                        type_name = *(next_token.value->str_value);
-                        if (Util::str_equals(type_name.c_str(), type_info.name.c_str()))
-                            field_info.type = type_name;
-                        else if (type_exists(type_name))
-                            field_info.type = type_name;
-                        else {
-                            printf("Unknown type: %s", type_name.c_str());
-                            exit(-1);
-                        }
-                    } else if (next_token.type == TokenType::NUM) {
-                        field_info.type = "number";
-                    } else if (next_token.type == TokenType::STR) {
-                        field_info.type = "string";
-                    } else if (next_token.type == TokenType::BOOL) {
-                        field_info.type = "bool";
-                    } else {
-                        Util::error("Expected type identifier at beginning of field declaration");
-                    }
-                    name_token = consume();
-                    std::string field_name = *(next_token.value->str_value);
-                    printf("got field name %s\n", field_name.c_str());
-                    if (name_token.type != TokenType::NAME) {
-                        Util::error("Expected identifier after field declaration");
+                    output += "number n" + std::to_string(global_index) + " = ";
+                    append_number();
+                    for (size_t j = 0; j < options.numbers_per_expression; ++j) {
+                        output += " + ";
+                        append_number();
                     }
-                    for (int i = 0; i < fields.size(); ++i) {
-                        if (Util::str_equals(field_name.c_str(), fields[i].name.c_str())) {
-                            printf("Duplicate identifier: %s", field_name.c_str());
-                            exit(-1);
-                        }
-                    }
-                    field_info.name = field_name;
-                    next_token = consume();
-                    if (next_token.type != TokenType::SEMICOLON)
-                        Util::error("Expected semicolon after field declaration");
-                    fields.push_back(field_info);
                 }
-                next_token = consume();
+                output += ";\n";
             }
-            types.push_back(type_info);
+            output += "\n";
         }
 
-        void parse_member_function(TypeInfo type) {
-
+        void indent(size_t depth) {
+            output.append(4 * depth, ' ');
         }
 
-        void parse_function() {
+        void generate_statements(size_t depth, size_t max_depth) {
+            std::string variable = "v" + std::to_string(variable_count++);
+            indent(depth);
+            output += "number " + variable + " = ";
+            append_number_expression("a");
+            output += ";\n";
+            indent(depth);
+            output += "string t" + variable + " = ";
+            append_string_literal();
+            output += ";\n";
+            if (depth >= max_depth)
+                return;
+            indent(depth);
+            output += random.below(2) == 0 ? "if (" : "while (";
+            output += variable + " < ";
+            append_number();
+            output += ") {\n";
+            generate_statements(depth + 1, max_depth);
+            indent(depth + 1);
+            output += variable + " = ";
+            append_number_expression(variable);
+            output += ";\n";
+            indent(depth);
+            output += "}\n";
+        }
 
+        void generate_function() {
+            size_t function_index = function_count++;
+            output += "function<number> g" + std::to_string(function_index) + "(number a, number b) {\n";
+            generate_statements(1, 1 + random.below(options.body_depth));
+            output += "    return a + b;\n}\n\n";
         }
+    };
 
-        void parse_global_var() {
+    bool parse_size(const char* text, size_t& value) {
+        char* end = nullptr;
+        double number = strtod(text, &end);
+        if (end == text || number < 0)
+            return false;
+        if (*end == 'k' || *end == 'K')
+            number *= 1024;
+        else if (*end == 'm' || *end == 'M')
+            number *= 1024 * 1024;
+        else if (*end == 'g' || *end == 'G')
+            number *= 1024.0 * 1024 * 1024;
+        value = static_cast<size_t>(number);
+        return true;
+    }
+
+    //liest die Optionen des Generators, liefert false bei unbekannten Argumenten
+    bool parse_corpus_option(const char** argv, int argc, int& i, CorpusOptions& options) {
+        if (i + 1 >= argc)
+            return false;
+        const char* value = argv[i + 1];
+        bool success = true;
+        if (Util::str_equals(argv[i], "--size"))
+            success = parse_size(value, options.target_bytes);
+        else if (Util::str_equals(argv[i], "--seed"))
+            options.seed = strtoull(value, nullptr, 10);
+        else if (Util::str_equals(argv[i], "--depth"))
+            options.hierarchy_depth = strtoul(value, nullptr, 10);
+        else if (Util::str_equals(argv[i], "--fields"))
+            options.max_fields = strtoul(value, nullptr, 10);
+        else if (Util::str_equals(argv[i], "--string-length"))
+            options.string_length = strtoul(value, nullptr, 10);
+        else if (Util::str_equals(argv[i], "--numbers"))
+            options.numbers_per_expression = strtoul(value, nullptr, 10);
+        else if (Util::str_equals(argv[i], "--body-depth"))
+            options.body_depth = strtoul(value, nullptr, 10);
+        else
+            return false;
+        ++i;
+        return success;
+    }
 
+    //coralc gen-corpus [Optionen] <Ausgabedatei>
+    int generate_main(int argc, const char** argv) {
+        CorpusOptions options;
+        std::string output_path;
+        for (int i = 0; i < argc; ++i) {
+            if (Util::str_starts_with(argv[i], "--")) {
+                if (!parse_corpus_option(argv, argc, i, options)) {
+                    printf("Unknown or invalid option: %s\n", argv[i]);
+                    return -1;
+                }
+            } else {
+                output_path = argv[i];
+            }
         }
+        if (output_path.empty()) {
+            printf("Usage: coralc gen-corpus [--size N[k|m|g]] [--seed N] [--depth N] [--fields N] [--string-length N] [--numbers N] [--body-depth N] <output>\n");
+            return -1;
+        }
+        CorpusGenerator generator(options);
+        if (!Util::write_file(output_path, generator.generate())) {
+            printf("Could not write file: %s\n", output_path.c_str());
+            return -1;
+        }
+        return 0;
+    }
+
+    enum Stage {
+        STAGE_READ,
+        STAGE_TOKENIZE,
+        STAGE_PARSE,
+        STAGE_COUNT
+    };
 
+    constexpr const char* STAGE_NAMES[] = {"read", "tokenize", "parse"};
 
+    struct StageResult {
+        double median_ms = 0;
+        double min_ms = 0;
+        double mb_per_s = 0;
+        double tokens_per_s = 0;
     };
 
-}
+    double milliseconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
 
-int main(int argc, const char** argv) {
-    if (argc <= 1) {
-        printf("Provide a path to a .crl file");
-        return -1;
+    StageResult summarize(std::vector<double>& samples, size_t bytes, size_t tokens) {
+        std::sort(samples.begin(), samples.end());
+        StageResult result;
+        result.min_ms = samples.front();
+        result.median_ms = samples[samples.size() / 2];
+        double seconds = result.median_ms / 1000.0;
+        if (seconds > 0) {
+            result.mb_per_s = bytes / (1024.0 * 1024.0) / seconds;
+            result.tokens_per_s = tokens / seconds;
+        }
+        return result;
+    }
+
+    //sucht in einer mit --save-baseline geschriebenen Datei den Wert key der Stufe stage. Kein allgemeiner JSON Parser
+    bool find_baseline_value(const std::string& json, const char* stage, const char* key, double& value) {
+        size_t position = json.find(std::string("\"") + stage + "\"");
+        if (position == std::string::npos)
+            return false;
+        size_t stage_end = json.find('}', position);
+        position = json.find(std::string("\"") + key + "\"", position);
+        if (position == std::string::npos || position > stage_end)
+            return false;
+        position = json.find(':', position);
+        if (position == std::string::npos)
+            return false;
+        value = strtod(json.c_str() + position + 1, nullptr);
+        return true;
+    }
+
+    //coralc bench [Optionen] [Dateien]. Ohne Dateien wird ein Korpus erzeugt. Das Ergebnis geht als JSON nach stdout,
+    //bei --baseline ist der Exit Code 1, wenn eine Stufe mehr als --tolerance Prozent langsamer ist
+    int bench_main(int argc, const char** argv) {
+        CorpusOptions corpus_options;
+        std::vector<std::string> paths;
+        size_t iterations = 10;
+        double tolerance = 10;
+        std::string baseline_path, save_baseline_path;
+        for (int i = 0; i < argc; ++i) {
+            if (Util::str_equals(argv[i], "--iterations") && i + 1 < argc) {
+                iterations = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+            } else if (Util::str_equals(argv[i], "--baseline") && i + 1 < argc) {
+                baseline_path = argv[++i];
+            } else if (Util::str_equals(argv[i], "--save-baseline") && i + 1 < argc) {
+                save_baseline_path = argv[++i];
+            } else if (Util::str_equals(argv[i], "--tolerance") && i + 1 < argc) {
+                tolerance = strtod(argv[++i], nullptr);
+            } else if (Util::str_starts_with(argv[i], "--")) {
+                if (!parse_corpus_option(argv, argc, i, corpus_options)) {
+                    printf("Unknown or invalid option: %s\n", argv[i]);
+                    return -1;
+                }
+            } else {
+                paths.push_back(argv[i]);
+            }
+        }
+        std::string generated_path;
+        if (paths.empty()) {
+            CorpusGenerator generator(corpus_options);
+            generated_path = (std::filesystem::temp_directory_path() / ("coral_bench_" + std::to_string(getpid()) + ".crl")).string();
+            if (!Util::write_file(generated_path, generator.generate())) {
+                printf("Could not write file: %s\n", generated_path.c_str());
+                return -1;
+            }
+            paths.push_back(generated_path);
+        }
+
+        std::vector<double> samples[STAGE_COUNT];
+        size_t total_bytes = 0, total_tokens = 0;
+        for (size_t iteration = 0; iteration < iterations; ++iteration) {
+            double elapsed[STAGE_COUNT] = {};
+            size_t bytes = 0, tokens = 0;
+            for (const std::string& path : paths) {
+                auto start = std::chrono::steady_clock::now();
+                Util::SourceBuffer source = Util::read_file(path.c_str());
+                //jede Seite einmal anfassen, sonst würden die Page Faults von mmap dem Tokenizer zugerechnet
+                volatile char touched = 0;
+                for (size_t offset = 0; offset < source.size(); offset += 4096)
+                    touched = touched + source.data()[offset];
+                elapsed[STAGE_READ] += milliseconds_since(start);
+                bytes += source.size();
+
+                Util::Arena arena;
+                Util::StringInterner interner(arena);
+                Tokenization::Tokenizer tokenizer(source.view(), interner);
+                start = std::chrono::steady_clock::now();
+                std::vector<Tokenization::Token> token_list = tokenizer.tokenize();
+                elapsed[STAGE_TOKENIZE] += milliseconds_since(start);
+                tokens += token_list.size();
+
+                Tokenization::VectorTokenSource token_source(token_list);
+                start = std::chrono::steady_clock::now();
+                Diagnostics::DiagnosticList diagnostics;
+                Parsing::Parser parser(token_source, interner, diagnostics, true);
+                Parsing::ParseInfo info = parser.parse();
+                elapsed[STAGE_PARSE] += milliseconds_since(start);
+                Parsing::release_parse_info(info);
+                if (!diagnostics.empty()) {
+                    Diagnostics::print({&diagnostics}, {path});
+                    return 1;
+                }
+            }
+            for (int stage = 0; stage < STAGE_COUNT; ++stage)
+                samples[stage].push_back(elapsed[stage]);
+            total_bytes = bytes;
+            total_tokens = tokens;
+        }
+        if (!generated_path.empty()) {
+            std::error_code error_code;
+            std::filesystem::remove(generated_path, error_code);
+        }
+
+        StageResult results[STAGE_COUNT];
+        for (int stage = 0; stage < STAGE_COUNT; ++stage)
+            results[stage] = summarize(samples[stage], total_bytes, total_tokens);
+        std::string json;
+        char line[256];
+        snprintf(line, sizeof(line), "{\n  \"bytes\": %zu,\n  \"tokens\": %zu,\n  \"iterations\": %zu,\n  \"stages\": {\n", total_bytes, total_tokens, iterations);
+        json += line;
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            snprintf(line, sizeof(line), "    \"%s\": {\"median_ms\": %.3f, \"min_ms\": %.3f, \"mb_per_s\": %.2f, \"tokens_per_s\": %.0f}%s\n",
+                     STAGE_NAMES[stage], results[stage].median_ms, results[stage].min_ms, results[stage].mb_per_s, results[stage].tokens_per_s,
+                     stage + 1 < STAGE_COUNT ? "," : "");
+            json += line;
+        }
+        json += "  }\n}\n";
+        printf("%s", json.c_str());
+
+        if (!save_baseline_path.empty() && !Util::write_file(save_baseline_path, json)) {
+            printf("Could not write file: %s\n", save_baseline_path.c_str());
+            return -1;
+        }
+        if (baseline_path.empty())
+            return 0;
+        std::ifstream baseline_file(baseline_path);
+        if (!baseline_file) {
+            printf("Could not read baseline: %s\n", baseline_path.c_str());
+            return -1;
+        }
+        std::stringstream baseline_stream;
+        baseline_stream << baseline_file.rdbuf();
+        std::string baseline = baseline_stream.str();
+        bool regressed = false;
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            double baseline_throughput = 0;
+            if (!find_baseline_value(baseline, STAGE_NAMES[stage], "mb_per_s", baseline_throughput) || baseline_throughput <= 0)
+                continue;
+            double change = (results[stage].mb_per_s / baseline_throughput - 1.0) * 100.0;
+            bool stage_regressed = change < -tolerance;
+            fprintf(stderr, "%-10s %10.2f MB/s  baseline %10.2f MB/s  %+7.1f%%%s\n", STAGE_NAMES[stage], results[stage].mb_per_s, baseline_throughput,
+                    change, stage_regressed ? "  REGRESSION" : "");
+            regressed |= stage_regressed;
+        }
+        return regressed ? 1 : 0;
     }
-    const char* file_path = argv[1];
-    std::string content = Util::read_file(file_path);
-    Tokenization::Tokenizer tokenizer(content);
 
-    std::vector<Tokenization::Token> tokens = tokenizer.tokenize();
+    //Micro-Benchmarks für den Interpreter. Jeder Fall definiert bench(n) mit einer Schleife über n Durchläufe
+    struct VmCase {
+        const char* name;
+        const char* source;
+    };
+
+    const VmCase VM_CASES[] = {
+        {"calls",
+         "function<number> add(number a, number b) { return a + b; }\n"
+         "function<number> bench(number n) {\n"
+         "    number i = 0;\n"
+         "    number total = 0;\n"
+         "    while (i < n) {\n"
+         "        total = add(total, i);\n"
+         "        i = i + 1;\n"
+         "    }\n"
+         "    return total;\n"
+         "}\n"},
+        {"arithmetic",
+         "function<number> bench(number n) {\n"
+         "    number i = 0;\n"
+         "    number x = 1;\n"
+         "    while (i < n) {\n"
+         "        x = x * 1.5 - i / 3 + 2;\n"
+         "        if (x > 1000000 || x < -1000000) { x = x / 1000; }\n"
+         "        i = i + 1;\n"
+         "    }\n"
+         "    return x;\n"
+         "}\n"},
+        {"fields",
+         "type Point { number x; number y; }\n"
+         "type Particle from Point {\n"
+         "    number speed;\n"
+         "    function<number> step() { x = x + speed; y = y + 1; return x; }\n"
+         "}\n"
+         "function<number> bench(number n) {\n"
+         "    Particle p = new Particle();\n"
+         "    Point q = p;\n"
+         "    p.speed = 2;\n"
+         "    number i = 0;\n"
+         "    while (i < n) {\n"
+         "        p.step();\n"
+         "        q.y = q.y + p.x - q.x;\n"
+         "        i = i + 1;\n"
+         "    }\n"
+         "    return q.y;\n"
+         "}\n"},
+        {"methods",
+         "type Shape {\n"
+         "    number size;\n"
+         "    function<number> get_size() { return size; }\n"
+         "    function<number> area() { return size * size; }\n"
+         "}\n"
+         "type Circle from Shape {\n"
+         "    function<number> area() { return size * size * 3; }\n"
+         "    function<number> grow(number by) { size = size + by; return size; }\n"
+         "}\n"
+         "function<number> bench(number n) {\n"
+         "    Circle c = new Circle();\n"
+         "    Shape s = c;\n"
+         "    number i = 0;\n"
+         "    number total = 0;\n"
+         "    while (i < n) {\n"
+         "        total = total + s.area() - c.area() + c.grow(1) + s.get_size();\n"
+         "        i = i + 1;\n"
+         "    }\n"
+         "    return total;\n"
+         "}\n"},
+        //ein Schleifendurchlauf verarbeitet 256 Elemente, gezählt wird je Element
+        {"intrinsics",
+         "intrinsic function<numbers> zeros(number length);\n"
+         "intrinsic function fill(numbers a, number value);\n"
+         "intrinsic function set(numbers a, number index, number value);\n"
+         "intrinsic function fma(numbers out, numbers a, numbers b, numbers c);\n"
+         "intrinsic function<number> dot(numbers a, numbers b);\n"
+         "function<number> bench(number n) {\n"
+         "    numbers a = zeros(256);\n"
+         "    numbers b = zeros(256);\n"
+         "    fill(a, 0.5);\n"
+         "    number i = 0;\n"
+         "    number total = 0;\n"
+         "    while (i < n) {\n"
+         "        set(b, i % 256, i);\n"
+         "        fma(b, a, a, b);\n"
+         "        total = total + dot(a, b);\n"
+         "        i = i + 256;\n"
+         "    }\n"
+         "    return total;\n"
+         "}\n"},
+    };
 
-    tokenizer.print_all_tokens();
+    //coralc bench-vm [--iterations N] [--loop N] [--no-devirtualize]. Das Ergebnis geht als JSON nach stdout
+    int vm_bench_main(int argc, const char** argv) {
+        size_t iterations = 10;
+        double loop_count = 1000000;
+        bool devirtualize = true;
+        for (int i = 0; i < argc; ++i) {
+            if (Util::str_equals(argv[i], "--iterations") && i + 1 < argc) {
+                iterations = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+            } else if (Util::str_equals(argv[i], "--loop") && i + 1 < argc) {
+                loop_count = std::max(1.0, strtod(argv[++i], nullptr));
+            } else if (Util::str_equals(argv[i], "--no-devirtualize")) {
+                devirtualize = false;
+            } else {
+                printf("Unknown or invalid option: %s\n", argv[i]);
+                return -1;
+            }
+        }
+        std::string json = "{\n  \"loop\": " + std::to_string(static_cast<uint64_t>(loop_count)) + ",\n  \"cases\": {\n";
+        size_t case_count = sizeof(VM_CASES) / sizeof(VM_CASES[0]);
+        for (size_t c = 0; c < case_count; ++c) {
+            std::string path = (std::filesystem::temp_directory_path() / ("coral_vm_bench_" + std::to_string(getpid()) + ".crl")).string();
+            if (!Util::write_file(path, VM_CASES[c].source)) {
+                printf("Could not write file: %s\n", path.c_str());
+                return -1;
+            }
+            Driver::Options options;
+            options.inputs.push_back(path);
+            options.devirtualize = devirtualize;
+            options.entry_points.push_back("bench");
+            Util::WorkStealingPool pool(1);
+            Driver::Program program;
+            Driver::compile_program(program, options, pool);
+            VM::Module module;
+            bool compiled = Driver::error_count(program) == 0 && VM::Compiler(program, module).compile();
+            std::error_code error_code;
+            std::filesystem::remove(path, error_code);
+            int function_index = compiled ? Driver::find_function(program, "bench") : -1;
+            if (function_index == -1) {
+                Driver::report_diagnostics(program);
+                printf("Could not compile benchmark %s\n", VM_CASES[c].name);
+                return -1;
+            }
+            std::vector<double> samples;
+            VM::Value argument, result = {};
+            argument.number = loop_count;
+            for (size_t iteration = 0; iteration < iterations; ++iteration) {
+                VM::Interpreter interpreter(module);
+                auto start = std::chrono::steady_clock::now();
+                if (!interpreter.call(*module.functions[function_index], &argument, 1, result)) {
+                    printf("Benchmark %s failed: %s\n", VM_CASES[c].name, interpreter.get_error().c_str());
+                    return -1;
+                }
+                samples.push_back(milliseconds_since(start));
+            }
+            std::sort(samples.begin(), samples.end());
+            double median_ms = samples[samples.size() / 2];
+            char line[256];
+            snprintf(line, sizeof(line), "    \"%s\": {\"median_ms\": %.3f, \"min_ms\": %.3f, \"ns_per_loop\": %.2f, \"result\": %.17g}%s\n", VM_CASES[c].name,
+                     median_ms, samples.front(), median_ms * 1e6 / loop_count, result.number, c + 1 < case_count ? "," : "");
+            json += line;
+        }
+        json += "  }\n}\n";
+        printf("%s", json.c_str());
+        return 0;
+    }
 
-    Parsing::Parser parser(tokens);
+}
 
-    Parsing::ParseInfo parse_result = parser.parse();
+int main(int argc, const char** argv) {
+    if (argc > 1 && Util::str_equals(argv[1], "gen-corpus"))
+        return Bench::generate_main(argc - 2, argv + 2);
+    if (argc > 1 && Util::str_equals(argv[1], "bench"))
+        return Bench::bench_main(argc - 2, argv + 2);
+    if (argc > 1 && Util::str_equals(argv[1], "bench-vm"))
+        return Bench::vm_bench_main(argc - 2, argv + 2);
+    if (argc > 1 && Util::str_equals(argv[1], "serve"))
+        return Server::serve_main(argc - 2, argv + 2);
+    auto start_time = std::chrono::steady_clock::now();
+    Driver::Options options;
+    if (const char* cache_directory = getenv("CORAL_CACHE_DIR"))
+        options.cache_directory = cache_directory;
+    bool time_passes = false, print_stats = false, stats_json = false, run = false, layout_report = false;
+    std::string emit_cpp_path;
+    std::vector<std::string> arguments, libraries;
+    for (int i = 1; i < argc; ++i) {
+        if (Util::str_equals(argv[i], "--stream")) {
+            options.streaming = true;
+        } else if (Util::str_equals(argv[i], "--decls-only")) {
+            options.decls_only = true;
+        } else if (Util::str_equals(argv[i], "--cache-dir") && i + 1 < argc) {
+            options.cache_directory = argv[++i];
+        } else if (Util::str_equals(argv[i], "--no-cache")) {
+            options.cache_directory.clear();
+        } else if (Util::str_equals(argv[i], "--run")) {
+            run = true;
+        } else if (Util::str_equals(argv[i], "--layout-report")) {
+            layout_report = true;
+        } else if (Util::str_equals(argv[i], "--emit-cpp") && i + 1 < argc) {
+            emit_cpp_path = argv[++i];
+        } else if (Util::str_equals(argv[i], "--link") && i + 1 < argc) {
+            libraries.push_back(argv[++i]);
+        } else if (Util::str_equals(argv[i], "--no-devirtualize")) {
+            options.devirtualize = false;
+        } else if (Util::str_equals(argv[i], "--no-fold")) {
+            options.fold_constants = false;
+        } else if (Util::str_equals(argv[i], "--no-escape")) {
+            options.replace_scalars = false;
+        } else if (Util::str_equals(argv[i], "--no-dce")) {
+            options.eliminate_dead_code = false;
+        } else if (Util::str_equals(argv[i], "--error-limit") && i + 1 < argc) {
+            Diagnostics::error_limit = strtoul(argv[++i], nullptr, 10);
+        } else if (Util::str_equals(argv[i], "-v")) {
+            Util::verbosity = Util::SUMMARY;
+        } else if (Util::str_equals(argv[i], "-vv")) {
+            Util::verbosity = Util::TRACE;
+        } else if (Util::str_equals(argv[i], "-q")) {
+            Util::verbosity = Util::QUIET;
+        } else if (Util::str_equals(argv[i], "--time-passes")) {
+            time_passes = true;
+        } else if (Util::str_equals(argv[i], "--stats")) {
+            print_stats = true;
+        } else if (Util::str_equals(argv[i], "--stats-json")) {
+            print_stats = time_passes = stats_json = true;
+        } else if ((Util::str_equals(argv[i], "-j") || Util::str_equals(argv[i], "--jobs")) && i + 1 < argc) {
+            options.jobs = strtoul(argv[++i], nullptr, 10);
+        } else if (Util::str_starts_with(argv[i], "-j") && argv[i][2] != '\0') {
+            options.jobs = strtoul(argv[i] + 2, nullptr, 10);
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    options.inputs = Driver::collect_inputs(arguments);
+    if (options.inputs.empty()) {
+        printf("Provide a path to a .crl file, a directory or an @manifest");
+        return -1;
+    }
+    Util::stats.enabled = time_passes || print_stats;
+    VM::Module module;
+    for (const std::string& library : libraries) {
+        void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr) {
+            printf("Could not load library %s: %s\n", library.c_str(), dlerror());
+            return -1;
+        }
+        module.libraries.push_back(handle);
+    }
 
-    Parsing::print_parse_info(parse_result);
+    Util::WorkStealingPool pool(options.jobs);
+    Driver::Program program;
+    Driver::compile_program(program, options, pool);
 
-    printf("DID NOT SEGFAULT YAYYY!");
-    return 0;
+    if (Util::log_enabled(Util::SUMMARY))
+        Parsing::print_parse_info(program.info);
+    if (layout_report)
+        Driver::print_layout_report(program);
+    if (run && Driver::error_count(program) == 0) {
+        Util::PhaseTimer timer(Util::PHASE_BYTECODE);
+        VM::Compiler(program, module).compile();
+        if (Util::log_enabled(Util::TRACE)) {
+            for (const std::unique_ptr<VM::CompiledFunction>& function : module.functions) {
+                if (function != nullptr)
+                    VM::disassemble(*function);
+            }
+            VM::disassemble(module.initializer);
+        }
+    }
+    bool write_failed = false;
+    if (!emit_cpp_path.empty() && Driver::error_count(program) == 0) {
+        Util::PhaseTimer timer(Util::PHASE_EMIT);
+        if (options.decls_only) {
+            for (size_t i = 0; i < program.info.function_count; ++i) {
+                if (program.is_live_function(i))
+                    Driver::ensure_function_body(program, i);
+            }
+            for (size_t i = 0; i < program.info.global_var_count; ++i) {
+                if (program.is_live_global(i))
+                    Driver::ensure_global_initializer(program, i);
+            }
+        }
+        if (Driver::error_count(program) == 0 && !Util::write_file(emit_cpp_path, CppBackend::Emitter(program).emit())) {
+            printf("Could not write file: %s\n", emit_cpp_path.c_str());
+            write_failed = true;
+        }
+    }
+    Util::log_flush();
+    size_t errors = Driver::report_diagnostics(program);
+    int exit_code = errors == 0 && !write_failed ? 0 : 1;
+    if (run && errors == 0) {
+        Util::PhaseTimer timer(Util::PHASE_RUN);
+        VM::Interpreter interpreter(module);
+        if (!interpreter.run()) {
+            fflush(stdout);
+            fprintf(stderr, "runtime error: %s\n", interpreter.get_error().c_str());
+            exit_code = 1;
+        }
+        fflush(stdout);
+    }
+    if (Util::stats.enabled) {
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+        Util::stats.report(time_passes, print_stats, stats_json, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    return exit_code;
 }